@@ -183,6 +183,8 @@ PhaseFieldMicrostructure::PhaseFieldMicrostructure() : Integrator()
 			pp.query("tol_rel", elastic.tol_rel);
 			pp.query("tol_abs", elastic.tol_abs);
 			pp.query("tstart", elastic.tstart);
+			pp.query("indexed", elastic.indexed); // Operator stores grain weights instead of mixed models
+			pp.query("indexed_slots", elastic.indexed_slots); // Largest grain weights kept per node if indexed
 
 			pp.queryclass("bc",elastic.bc);
 
@@ -507,50 +509,69 @@ void PhaseFieldMicrostructure::TimeStepBegin(amrex::Real time, int iter)
 	for (int lev = 0; lev < rhs_mf.size(); lev++)
 		rhs_mf[lev]->setVal(0.0);
 
-	Operator::Elastic<model_type> elasticop;
-	elasticop.SetUniform(false);
+	// The operator and solver persist between elastic steps and are only
+	// rebuilt if the grids have changed since the last one.
 	amrex::LPInfo info;
 	//info.setMaxCoarseningLevel(0);
-	elasticop.define(geom, grids, dmap, info);
-
-	// Set linear elastic model
-	Set::Field<model_type> model_mf;
-	model_mf.resize(disp_mf.size());
+	elastic.solver.Define(geom, grids, dmap, info);
+	Operator::Elastic<model_type> &elasticop = elastic.solver.Op();
+
+	// Set linear elastic model: either the combined model at every node, or (indexed)
+	// only the largest grain weights, from which the operator and the solver mix the
+	// models themselves
+	Set::Field<model_type> &model_mf = elastic.model_mf;
+	Set::Field<Set::Scalar> &weights_mf = elastic.weights_mf;
+	const int nslots = elastic.indexed_slots;
+	if (elastic.indexed) weights_mf.resize(disp_mf.size());
+	else model_mf.resize(disp_mf.size());
 	for (int lev = 0; lev < rhs_mf.size(); ++lev)
 	{
 		amrex::Box domain(geom[lev].Domain());
 		domain.convert(amrex::IntVect::TheNodeVector());
-		model_mf.Define(lev,disp_mf[lev]->boxArray(), disp_mf[lev]->DistributionMap(), 1, 2);
+		if (!elastic.indexed &&
+		    (!model_mf[lev] ||
+		     model_mf[lev]->boxArray() != disp_mf[lev]->boxArray() ||
+		     model_mf[lev]->DistributionMap() != disp_mf[lev]->DistributionMap()))
+			model_mf.Define(lev,disp_mf[lev]->boxArray(), disp_mf[lev]->DistributionMap(), 1, 2);
+		if (elastic.indexed &&
+		    (!weights_mf[lev] ||
+		     weights_mf[lev]->boxArray() != disp_mf[lev]->boxArray() ||
+		     weights_mf[lev]->DistributionMap() != disp_mf[lev]->DistributionMap()))
+			weights_mf.Define(lev,disp_mf[lev]->boxArray(), disp_mf[lev]->DistributionMap(), 2*nslots, 2);
 
 		eta_new_mf[lev]->FillBoundary();
 
 		Set::Vector DX(geom[lev].CellSize());
 
-		for (MFIter mfi(*model_mf[lev], false); mfi.isValid(); ++mfi)
+		for (MFIter mfi(*disp_mf[lev], false); mfi.isValid(); ++mfi)
 		{
 			amrex::Box bx = mfi.grownnodaltilebox(2);
 
-			amrex::Array4<model_type> const &model = model_mf[lev]->array(mfi);
+			amrex::Array4<model_type> const &model = elastic.indexed ? amrex::Array4<model_type>() : model_mf[lev]->array(mfi);
 			amrex::Array4<const Set::Scalar> const &eta = eta_new_mf[lev]->array(mfi);
+			amrex::Array4<Set::Scalar> const &weights = elastic.indexed ? weights_mf[lev]->array(mfi) : amrex::Array4<Set::Scalar>();
+			const bool indexed = elastic.indexed;
 
 			amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
 				std::vector<Set::Scalar> etas(number_of_grains);
 				for (int n = 0; n < number_of_grains; n++) etas[n] = 0.25*(eta(i,j,k,n) + eta(i,j-1,k,n) + eta(i-1,j,k,n) + eta(i-1,j-1,k,n));
-				model(i, j, k) = model_type::Combine(elastic.model,etas);
+				if (indexed) Model::Solid::Select(etas.data(), nullptr, number_of_grains, weights, nslots, i, j, k);
+				else model(i, j, k) = model_type::Combine(elastic.model,etas);
 			});
 		}
 
-		Util::RealFillBoundary(*model_mf[lev],elasticop.Geom(lev));
+		if (elastic.indexed) Util::RealFillBoundary(*weights_mf[lev],elasticop.Geom(lev));
+		else Util::RealFillBoundary(*model_mf[lev],elasticop.Geom(lev));
 	}
-	elasticop.SetModel(model_mf);
+	elasticop.SetIndexed(elastic.indexed, nslots);
+	if (elastic.indexed) elasticop.SetModel(elastic.model,weights_mf);
+	else elasticop.SetModel(model_mf);
 
 	elastic.bc.SetTime(time);
 	elastic.bc.Init(rhs_mf,geom);
 	elasticop.SetBC(&elastic.bc);
 
-	Solver::Nonlocal::Newton<model_type> linearsolver(elasticop);
-	IO::ParmParse pp("elastic");
-	pp.queryclass("solver",linearsolver);
+	Solver::Nonlocal::Newton<model_type> &linearsolver = elastic.solver.Solver();
 	linearsolver.solve(disp_mf, rhs_mf, model_mf, 1E-8, 1E-8);
 
 	linearsolver.W(energy_mf,disp_mf,model_mf);
@@ -10,6 +10,8 @@
 #include "Elastic.H"
 
 #include "Numeric/Stencil.H"
+
+#include <algorithm>
 namespace Operator
 {
 template<class T>
@@ -39,37 +41,298 @@ Elastic<T>::define (const Vector<Geometry>& a_geom,
 
 	Operator::define(a_geom,a_grids,a_dmap,a_info,a_factory);
 
-	int model_nghost = 2;
-
 	model.resize(m_num_amr_levels);
+	m_packed_model.resize(m_num_amr_levels);
+	m_float_model.resize(m_num_amr_levels);
+	m_uniform_weights.resize(m_num_amr_levels);
+	m_coeff_halo.resize(m_num_amr_levels);
+	m_dirty.resize(m_num_amr_levels);
+	m_dirty_base.assign(m_num_amr_levels,-1);
+	m_dirty_version.assign(m_num_amr_levels,-1);
+	m_average_version.assign(m_num_amr_levels,-1);
 	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
 	{
 		model[amrlev].resize(m_num_mg_levels[amrlev]);
+		m_packed_model[amrlev].resize(m_num_mg_levels[amrlev]);
+		m_float_model[amrlev].resize(m_num_mg_levels[amrlev]);
+		m_uniform_weights[amrlev].resize(m_num_mg_levels[amrlev]);
+		m_coeff_halo[amrlev].resize(m_num_mg_levels[amrlev]);
+		m_dirty[amrlev].resize(m_num_mg_levels[amrlev]);
 		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
 		{
-			model[amrlev][mglev].reset(new MultiTab(amrex::convert(m_grids[amrlev][mglev],
-									       amrex::IntVect::TheNodeVector()),
-								m_dmap[amrlev][mglev], 1, model_nghost));
+			DefineModel(amrlev,mglev);
+			m_dirty[amrlev][mglev].assign(m_grids[amrlev][mglev].size(),0);
+		}
+	}
+}
+
+template<class T>
+void
+Elastic<T>::DefineModel (int amrlev, int mglev)
+{
+	int model_nghost = 2;
+
+	model[amrlev][mglev].reset();
+	m_packed_model[amrlev][mglev].reset();
+	m_float_model[amrlev][mglev].reset();
+
+	// Uniform moduli do not need a per-node model hierarchy
+	if (m_uniform) return;
+
+	amrex::BoxArray ba = amrex::convert(m_grids[amrlev][mglev], amrex::IntVect::TheNodeVector());
+	if (m_indexed)
+	{
+		// Nodes that are never set (outside the domain or the patches) hold phase 0
+		m_packed_model[amrlev][mglev].reset(new amrex::MultiFab(ba, m_dmap[amrlev][mglev], 2*m_nslots, model_nghost));
+		m_packed_model[amrlev][mglev]->setVal(0.0);
+		m_packed_model[amrlev][mglev]->setVal(1.0, 1, 1, model_nghost);
+	}
+	else if (FloatModel(mglev))
+	{
+		// Nodes that are never restricted to are converted to double along with the rest
+		m_float_model[amrlev][mglev].reset(new amrex::FabArray<amrex::BaseFab<float> >(ba, m_dmap[amrlev][mglev], T::NPack, model_nghost));
+		m_float_model[amrlev][mglev]->setVal(0.0);
+	}
+	else if (m_packed)
+		m_packed_model[amrlev][mglev].reset(new amrex::MultiFab(ba, m_dmap[amrlev][mglev], T::NPack, model_nghost));
+	else
+		model[amrlev][mglev].reset(new MultiTab(ba, m_dmap[amrlev][mglev], 1, model_nghost));
+}
+
+template<class T>
+void
+Elastic<T>::SetUniform (bool a_uniform)
+{
+	BL_PROFILE("Operator::Elastic::SetUniform()");
+	if (a_uniform == m_uniform) return;
+
+	// Keep the model before the hierarchy is released, if it is the same everywhere
+	if (a_uniform && !model.empty() && m_model_set)
+	{
+		T uniform_model;
+		bool uniform = true;
+		for (int amrlev = 0; amrlev < m_num_amr_levels && uniform; amrlev++)
+		{
+			T level_model;
+			uniform = UniformModel(amrlev,level_model) && (amrlev == 0 || !Model::Solid::Differs(level_model,uniform_model));
+			uniform_model = level_model;
+		}
+		if (!uniform)
+		{
+			Util::Warning(INFO,"Moduli are not uniform; keeping a model per node");
+			return;
 		}
+		m_uniform_model = uniform_model;
+	}
+
+	m_uniform = a_uniform;
+	CoeffsChanged();
+
+	if (model.empty()) return; // not yet defined; define() will honor the flag
+
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+			DefineModel(amrlev,mglev);
+
+	if (!m_uniform && m_model_set) SetModel(m_uniform_model);
+}
+
+template<class T>
+void
+Elastic<T>::SetPacked (bool a_packed)
+{
+	BL_PROFILE("Operator::Elastic::SetPacked()");
+	if (a_packed == m_packed) return;
+	m_packed = a_packed;
+	CoeffsChanged();
+
+	if (model.empty() || m_uniform || m_indexed) return;
+
+	// Convert the models that were set on mglev 0; the coarser mg levels
+	// are rebuilt by averageDownCoeffs.
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	{
+		std::unique_ptr<MultiTab> old_model = std::move(model[amrlev][0]);
+		std::unique_ptr<amrex::MultiFab> old_packed = std::move(m_packed_model[amrlev][0]);
+
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+			DefineModel(amrlev,mglev);
+
+		if (!m_model_set) continue;
+		if (m_packed && old_model)
+			Model::Solid::Scatter(*old_model, *m_packed_model[amrlev][0], old_model->nGrow());
+		else if (!m_packed && old_packed)
+			Model::Solid::Gather(*old_packed, *model[amrlev][0], old_packed->nGrow());
+	}
+}
+
+template<class T>
+void
+Elastic<T>::SetMixedPrecision (int a_mglev)
+{
+	BL_PROFILE("Operator::Elastic::SetMixedPrecision()");
+	if (a_mglev < 1 && a_mglev != -1) Util::Abort(INFO,"Single precision starts at multigrid level 1 or above (got ",a_mglev,")");
+	if (a_mglev == m_float_mglev) return;
+	if (a_mglev > 0 && (m_uniform || m_indexed))
+		Util::Warning(INFO,"Uniform and indexed storage keep their coefficients in double precision");
+	m_float_mglev = a_mglev;
+	CoeffsChanged();
+
+	if (model.empty()) return;
+
+	// Only the coarser mg levels change storage; they are rebuilt by averageDownCoeffs
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+		for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
+			DefineModel(amrlev,mglev);
+}
+
+template<class T>
+void
+Elastic<T>::SetIndexed (bool a_indexed, int a_nslots)
+{
+	BL_PROFILE("Operator::Elastic::SetIndexed()");
+	if (a_nslots < 1 || a_nslots > Model::Solid::MaxSlots)
+		Util::Abort(INFO,"Indexed storage needs 1 to ",Model::Solid::MaxSlots," phases per node, got ",a_nslots);
+	if (a_indexed == m_indexed && (!m_indexed || a_nslots == m_nslots)) return;
+	m_indexed = a_indexed;
+	m_nslots = a_nslots;
+	m_phases.clear();
+	CoeffsChanged();
+
+	if (model.empty()) return;
+
+	// Per-node models and phase weights cannot be converted into each other,
+	// so the storage is reallocated and has to be set again.
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+			DefineModel(amrlev,mglev);
+	if (!m_uniform) m_model_set = false;
+}
+
+template<class T>
+bool
+Elastic<T>::SetPhases (const std::vector<T> &a_phases)
+{
+	if (a_phases.empty()) Util::Abort(INFO,"At least one phase is required");
+	std::vector<Set::Scalar> phases(a_phases.size()*T::NPack);
+	for (unsigned int n = 0; n < a_phases.size(); n++) a_phases[n].Pack(&phases[n*T::NPack]);
+	if (phases == m_phases) return false;
+	m_phases = phases;
+	return true;
+}
+
+template<class T>
+bool
+Elastic<T>::UniformModel (const amrex::FabArray<amrex::BaseFab<T> > &a_model, T &a_uniform) const
+{
+	BL_PROFILE("Operator::Elastic::UniformModel()");
+
+	// The reference is the low corner of the first box, so all ranks agree on it
+	Set::Scalar buf[T::NPack];
+	for (int n = 0; n < T::NPack; n++) buf[n] = 0.0;
+	for (MFIter mfi(a_model); mfi.isValid(); ++mfi)
+		if (mfi.index() == 0) a_model[mfi](mfi.validbox().smallEnd()).Pack(buf);
+	amrex::ParallelDescriptor::Bcast(buf, T::NPack, a_model.DistributionMap()[0]);
+	a_uniform.Unpack(buf);
+
+	int differs = 0;
+	for (MFIter mfi(a_model, amrex::TilingIfNotGPU()); mfi.isValid() && !differs; ++mfi)
+		differs = Model::Solid::Differs(mfi.tilebox(), a_model.const_array(mfi), a_uniform);
+	amrex::ParallelDescriptor::ReduceIntMax(differs);
+	return !differs;
+}
+
+template<class T>
+bool
+Elastic<T>::UniformModel (int amrlev, T &a_uniform) const
+{
+	if (model[amrlev][0]) return UniformModel(*model[amrlev][0],a_uniform);
+
+	// Unpack (or mix) the valid nodes first
+	const amrex::MultiFab &packed = *m_packed_model[amrlev][0];
+	amrex::FabArray<amrex::BaseFab<T> > unpacked(packed.boxArray(), packed.DistributionMap(), 1, 0);
+	for (MFIter mfi(unpacked, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		if (m_indexed) Model::Solid::Mix(mfi.tilebox(), m_phases.data(), (int)(m_phases.size()/T::NPack), packed.const_array(mfi), m_nslots, unpacked.array(mfi));
+		else Model::Solid::Gather(mfi.tilebox(), packed.const_array(mfi), unpacked.array(mfi));
+	}
+	return UniformModel(unpacked,a_uniform);
+}
+
+template<class T>
+amrex::Array4<T>
+Elastic<T>::ModelArray (int amrlev, int mglev, const MFIter &mfi, const Box &bx, TArrayBox &buf) const
+{
+	if (FloatModel(mglev))
+	{
+		const amrex::FabArray<amrex::BaseFab<float> > &packed = *m_float_model[amrlev][mglev];
+		amrex::Box gbx = amrex::grow(bx,1) & packed[mfi].box();
+		buf.resize(gbx,1);
+		Model::Solid::Gather(gbx, packed.const_array(mfi), buf.array());
+		return buf.array();
 	}
+	if (!m_packed && !m_indexed) return (*(model[amrlev][mglev])).array(mfi);
+
+	// Gather one layer beyond bx so that gradients of the moduli can be taken
+	const amrex::MultiFab &packed = *m_packed_model[amrlev][mglev];
+	amrex::Box gbx = amrex::grow(bx,1) & packed[mfi].box();
+	buf.resize(gbx,1);
+	if (m_indexed) Model::Solid::Mix(gbx, m_phases.data(), (int)(m_phases.size()/T::NPack), packed.const_array(mfi), m_nslots, buf.array());
+	else Model::Solid::Gather(gbx, packed.array(mfi), buf.array());
+	return buf.array();
 }
 
 template <class T>
 void 
 Elastic<T>::SetModel (T &a_model)
 {
+	if (m_uniform)
+	{
+		if (!m_model_set || Model::Solid::Differs(a_model,m_uniform_model)) CoeffsChanged();
+		m_uniform_model = a_model;
+		m_model_set = true;
+		return;
+	}
+
+	if (m_indexed)
+	{
+		// A single phase with unit weight everywhere
+		SetPhases(std::vector<T>(1,a_model));
+		for (int amrlev = 0; amrlev < m_num_amr_levels; amrlev++)
+		{
+			amrex::MultiFab &slots = *m_packed_model[amrlev][0];
+			slots.setVal(0.0);
+			slots.setVal(1.0, 1, 1, slots.nGrow());
+		}
+		CoeffsChanged();
+		m_model_set = true;
+		return;
+	}
+
 	for (int amrlev = 0; amrlev < model.size(); amrlev++)
 	{
 		amrex::Box domain(m_geom[amrlev][0].Domain());
 		domain.convert(amrex::IntVect::TheNodeVector());
 
-		int nghost = model[amrlev][0]->nGrow();
+		const amrex::FabArrayBase &storage = m_packed ?
+			static_cast<const amrex::FabArrayBase&>(*m_packed_model[amrlev][0]) :
+			static_cast<const amrex::FabArrayBase&>(*model[amrlev][0]);
+		int nghost = storage.nGrow();
 
-		for (MFIter mfi(*model[amrlev][0], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		for (MFIter mfi(storage, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 		{
 			Box bx = mfi.tilebox();
 			bx.grow(nghost);   // Expand to cover first layer of ghost nodes
 			bx = bx & domain;  // Take intersection of box and the problem domain
+
+			if (m_packed)
+			{
+				amrex::Array4<Set::Scalar> const& P = m_packed_model[amrlev][0]->array(mfi);
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						Model::Solid::Scatter(a_model,P,i,j,k);
+					});
+				continue;
+			}
 				
 			amrex::Array4<T> const& C         = (*(model[amrlev][0])).array(mfi);
 	
@@ -78,6 +341,7 @@ Elastic<T>::SetModel (T &a_model)
 				});
 		}
 	}
+	CoeffsChanged();
 	m_model_set = true;
 }
 
@@ -87,16 +351,43 @@ Elastic<T>::SetModel (int amrlev, const amrex::FabArray<amrex::BaseFab<T> >& a_m
 {
 	BL_PROFILE("Operator::Elastic::SetModel()");
 
+	if (m_uniform)
+	{
+		T uniform_model;
+		if (UniformModel(a_model,uniform_model))
+		{
+			if (!m_model_set || Model::Solid::Differs(uniform_model,m_uniform_model)) CoeffsChanged();
+			m_uniform_model = uniform_model;
+			m_model_set = true;
+			return;
+		}
+		Util::Warning(INFO,"Moduli on amrlev=",amrlev," are not uniform; storing a model per node instead");
+		SetUniform(false);
+	}
+
+	if (m_indexed) Util::Abort(INFO,"Per-node models cannot be set with indexed storage: set the phases and their weights instead");
+
 	amrex::Box domain(m_geom[amrlev][0].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
 
-	if (a_model.boxArray()        != model[amrlev][0]->boxArray()) Util::Abort(INFO,"Inconsistent box arrays\n","a_model.boxArray()=\n",a_model.boxArray(),"\n but the current box array is \n",model[amrlev][0]->boxArray());
-	if (a_model.DistributionMap() != model[amrlev][0]->DistributionMap()) Util::Abort(INFO,"Inconsistent distribution maps");
-	if (a_model.nComp()           != model[amrlev][0]->nComp()) Util::Abort(INFO,"Inconsistent # of components - should be ",model[amrlev][0]->nComp());
-	if (a_model.nGrow()           != model[amrlev][0]->nGrow()) Util::Abort(INFO,"Inconsistent # of ghost nodes, should be ",model[amrlev][0]->nGrow());
+	const amrex::FabArrayBase &storage = m_packed ?
+		static_cast<const amrex::FabArrayBase&>(*m_packed_model[amrlev][0]) :
+		static_cast<const amrex::FabArrayBase&>(*model[amrlev][0]);
+
+	if (a_model.boxArray()        != storage.boxArray()) Util::Abort(INFO,"Inconsistent box arrays\n","a_model.boxArray()=\n",a_model.boxArray(),"\n but the current box array is \n",storage.boxArray());
+	if (a_model.DistributionMap() != storage.DistributionMap()) Util::Abort(INFO,"Inconsistent distribution maps");
+	if (a_model.nComp()           != 1) Util::Abort(INFO,"Inconsistent # of components - should be 1");
+	if (a_model.nGrow()           != storage.nGrow()) Util::Abort(INFO,"Inconsistent # of ghost nodes, should be ",storage.nGrow());
 
 
-	int nghost = model[amrlev][0]->nGrow();
+	int nghost = storage.nGrow();
+
+	// Only boxes whose models differ from the stored ones are copied and flagged;
+	// if none do, the averaged hierarchy, diagonal etc. are reused as they are.
+	// Stored models under the next finer level are the averaged fine ones, not the
+	// input, so they are left out of the comparison.
+	std::vector<int> changed(storage.boxArray().size(),0);
+	const amrex::BoxArray covered = Covered(amrlev);
 
 	for (MFIter mfi(a_model, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
@@ -104,19 +395,222 @@ Elastic<T>::SetModel (int amrlev, const amrex::FabArray<amrex::BaseFab<T> >& a_m
 		bx.grow(nghost);   // Expand to cover first layer of ghost nodes
 		bx = bx & domain;  // Take intersection of box and the problem domain
 			
-		amrex::Array4<T> const& C         = (*(model[amrlev][0])).array(mfi);
 		amrex::Array4<const T> const& a_C = a_model.array(mfi);
 
+		if (m_packed)
+		{
+			amrex::Array4<Set::Scalar> const& P = m_packed_model[amrlev][0]->array(mfi);
+			if (m_model_set)
+			{
+				bool differs = false;
+				for (const Box &ubx : Uncovered(bx,covered))
+					if ((differs = Model::Solid::Differs(ubx, a_C, amrex::Array4<const Set::Scalar>(P)))) break;
+				if (!differs) continue;
+			}
+			changed[mfi.index()] = 1;
+			Model::Solid::Scatter(bx, a_C, P);
+			continue;
+		}
+
+		amrex::Array4<T> const& C         = (*(model[amrlev][0])).array(mfi);
+		if (m_model_set)
+		{
+			bool differs = false;
+			for (const Box &ubx : Uncovered(bx,covered))
+				if ((differs = Model::Solid::Differs(ubx, a_C, amrex::Array4<const T>(C)))) break;
+			if (!differs) continue;
+		}
+		changed[mfi.index()] = 1;
+
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
 				C(i,j,k) = a_C(i,j,k);
 			});
 	}
-	//FillBoundaryCoeff(*model[amrlev][0], m_geom[amrlev][0]);
 
+	TrackChanges(amrlev,changed);
+	m_model_set = true;
+}
+
+template <class T>
+void
+Elastic<T>::SetModel (const std::vector<T> &a_phases, int amrlev, const amrex::MultiFab &a_weights)
+{
+	BL_PROFILE("Operator::Elastic::SetModel()");
+
+	if (a_weights.nComp() != 2*m_nslots) Util::Abort(INFO,"Got ",a_weights.nComp()," components of phase slots, expected ",2*m_nslots);
+
+	if (m_uniform)
+	{
+		// Mix the models on the valid nodes and take the uniform model from those
+		std::vector<Set::Scalar> phases(a_phases.size()*T::NPack);
+		for (unsigned int n = 0; n < a_phases.size(); n++) a_phases[n].Pack(&phases[n*T::NPack]);
+		amrex::FabArray<amrex::BaseFab<T> > mixed(a_weights.boxArray(), a_weights.DistributionMap(), 1, 0);
+		for (MFIter mfi(mixed, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			Model::Solid::Mix(mfi.tilebox(), phases.data(), (int)a_phases.size(), a_weights.const_array(mfi), m_nslots, mixed.array(mfi));
+		T uniform_model;
+		if (UniformModel(mixed,uniform_model))
+		{
+			if (!m_model_set || Model::Solid::Differs(uniform_model,m_uniform_model)) CoeffsChanged();
+			m_uniform_model = uniform_model;
+			m_model_set = true;
+			return;
+		}
+		Util::Warning(INFO,"Moduli on amrlev=",amrlev," are not uniform; storing a model per node instead");
+		SetUniform(false);
+	}
+
+	if (!m_indexed) Util::Abort(INFO,"Phase weights can only be set with indexed storage (SetIndexed)");
+
+	// A new phase table changes the models everywhere
+	const bool all = SetPhases(a_phases) || !m_model_set;
+
+	amrex::MultiFab &weights = *m_packed_model[amrlev][0];
+	if (a_weights.boxArray()        != weights.boxArray()) Util::Abort(INFO,"Inconsistent box arrays\n","a_weights.boxArray()=\n",a_weights.boxArray(),"\n but the current box array is \n",weights.boxArray());
+	if (a_weights.DistributionMap() != weights.DistributionMap()) Util::Abort(INFO,"Inconsistent distribution maps");
+	if (a_weights.nGrow()           != weights.nGrow()) Util::Abort(INFO,"Inconsistent # of ghost nodes, should be ",weights.nGrow());
 
+	amrex::Box domain(m_geom[amrlev][0].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	const int nghost = weights.nGrow(), ncomp = weights.nComp();
+
+	// As with per-node models, only boxes whose weights changed are copied and flagged
+	std::vector<int> changed(weights.boxArray().size(),0);
+	const amrex::BoxArray covered = Covered(amrlev);
+
+	for (MFIter mfi(a_weights, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		Box bx = mfi.tilebox();
+		bx.grow(nghost);   // Expand to cover first layer of ghost nodes
+		bx = bx & domain;  // Take intersection of box and the problem domain
+
+		amrex::Array4<const Set::Scalar> const& a_W = a_weights.array(mfi);
+		amrex::Array4<Set::Scalar> const& W         = weights.array(mfi);
+
+		if (!all)
+		{
+			bool differs = false;
+			for (const Box &ubx : Uncovered(bx,covered))
+				if ((differs = Model::Solid::Differs(ubx, ncomp, a_W, amrex::Array4<const Set::Scalar>(W)))) break;
+			if (!differs) continue;
+		}
+		changed[mfi.index()] = 1;
+
+		amrex::ParallelFor (bx,ncomp,[=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+				W(i,j,k,n) = a_W(i,j,k,n);
+			});
+	}
+
+	if (all) CoeffsChanged();
+	else TrackChanges(amrlev,changed);
 	m_model_set = true;
 }
 
+template<class T>
+bool
+Elastic<T>::TrackChanges (int amrlev, std::vector<int> &a_changed)
+{
+	amrex::ParallelDescriptor::ReduceIntMax(a_changed.data(), (int)a_changed.size());
+
+	bool any = false;
+	for (unsigned int i = 0; i < a_changed.size(); i++)
+		if (a_changed[i]) { m_dirty[amrlev][0][i] = 1; any = true; }
+	if (!any) return false;
+
+	// Coarser AMR levels change as well (see CoeffsChanged). A change that was not
+	// recorded here (SetBC, SetPacked, ...) rules out partial updates until the next solve.
+	for (int lev = 0; lev <= amrlev; lev++)
+	{
+		if (m_dirty_base[lev] == -1) m_dirty_base[lev] = m_coeffs_version[lev];
+		else if (m_coeffs_version[lev] != m_dirty_version[lev]) m_dirty_base[lev] = -2;
+	}
+	CoeffsChanged(amrlev);
+	for (int lev = 0; lev <= amrlev; lev++) m_dirty_version[lev] = m_coeffs_version[lev];
+	return true;
+}
+
+template<class T>
+amrex::BoxArray
+Elastic<T>::Covered (int amrlev) const
+{
+	if (!m_average_down_amr || amrlev+1 >= m_num_amr_levels) return amrex::BoxArray();
+
+	// Same nodes as written by averageDownCoeffsToCoarseAmrLevel, with periodic images
+	amrex::BoxArray fine = amrex::convert(m_grids[amrlev+1][0], amrex::IntVect::TheNodeVector());
+	fine.coarsen(2);
+	amrex::BoxList covered(amrex::IndexType::TheNodeType());
+	for (const amrex::IntVect &iv : m_geom[amrlev][0].periodicity().shiftIntVect())
+		for (int i = 0; i < (int)fine.size(); i++)
+		{
+			amrex::Box bx = fine[i];
+			covered.push_back(bx.shift(iv));
+		}
+	return amrex::BoxArray(covered);
+}
+
+template<class T>
+amrex::BoxList
+Elastic<T>::Uncovered (const amrex::Box &a_bx, const amrex::BoxArray &a_covered)
+{
+	if (a_covered.empty()) return amrex::BoxList(a_bx);
+	return a_covered.complementIn(a_bx);
+}
+
+template<class T>
+bool
+Elastic<T>::Partial (int amrlev, int a_version) const
+{
+	if (m_geom[amrlev][0].isAnyPeriodic()) return false; // periodic images are not tracked
+	return m_dirty_base[amrlev] >= 0
+		&& m_coeffs_version[amrlev] == m_dirty_version[amrlev]
+		&& a_version == m_dirty_base[amrlev];
+}
+
+template<class T>
+void
+Elastic<T>::MarkDirty (const amrex::BoxArray &a_fine, const std::vector<int> &a_fine_dirty,
+		       const amrex::BoxArray &a_crse, std::vector<int> &a_crse_dirty)
+{
+	for (unsigned int i = 0; i < a_fine_dirty.size(); i++)
+	{
+		if (!a_fine_dirty[i]) continue;
+		// Nodes reached by the restriction stencil of the fine box and its ghosts
+		amrex::Box fbx = amrex::convert(a_fine[i], amrex::IntVect::TheNodeVector());
+		fbx.grow(2); fbx.coarsen(2); fbx.grow(1);
+		// Coarse boxes whose nodes, including 2 ghost layers, touch fbx: in terms of
+		// cells, those intersecting the cells of fbx grown by 2 (plus one on the low side)
+		amrex::Box query(fbx.smallEnd() - amrex::IntVect::TheUnitVector(), fbx.bigEnd());
+		query.grow(2);
+		for (const std::pair<int,amrex::Box> &isect : a_crse.intersections(query))
+			a_crse_dirty[isect.first] = 1;
+	}
+}
+
+template<class T>
+void
+Elastic<T>::MarkDirty ()
+{
+	BL_PROFILE("Operator::Elastic::MarkDirty()");
+	for (int amrlev = m_num_amr_levels-1; amrlev >= 0; --amrlev)
+	{
+		for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
+			MarkDirty(m_grids[amrlev][mglev-1], m_dirty[amrlev][mglev-1], m_grids[amrlev][mglev], m_dirty[amrlev][mglev]);
+		if (amrlev > 0)
+			MarkDirty(m_grids[amrlev][0], m_dirty[amrlev][0], m_grids[amrlev-1][0], m_dirty[amrlev-1][0]);
+	}
+}
+
+template<class T>
+void
+Elastic<T>::ResetChanges ()
+{
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	{
+		m_dirty_base[amrlev] = -1;
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+			std::fill(m_dirty[amrlev][mglev].begin(), m_dirty[amrlev][mglev].end(), 0);
+	}
+}
+
 //template <class T>
 //void
 //Elastic<T>::SetHomogeneous (bool a_homogeneous)
@@ -153,138 +647,334 @@ void
 Elastic<T>::Fapply (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u) const
 {
 	BL_PROFILE("Operator::Elastic::Fapply()");
+	Apply(amrlev,mglev,a_f,a_u,-1);
+}
+
+template<class T>
+void
+Elastic<T>::FapplyColor (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u, int color) const
+{
+	BL_PROFILE("Operator::Elastic::FapplyColor()");
+	Apply(amrlev,mglev,a_f,a_u,color);
+}
+
+template<class T>
+void
+Elastic<T>::Apply (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u, int color) const
+{
+	if (StencilAssembled(amrlev,mglev))
+	{
+		FapplyAssembled(amrlev,mglev,a_f,a_u,color);
+		return;
+	}
+	if (m_uniform)
+	{
+		ApplyUniform(amrlev,mglev,a_f,a_u,color);
+		return;
+	}
 
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
 
 	const Real* DX = m_geom[amrlev][mglev].CellSize();
 
+	TArrayBox cbuf; // Gathered models, if stored packed
+
 	for (MFIter mfi(a_f, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
 		Box bx = mfi.tilebox();
 		bx.grow(1);        // Expand to cover first layer of ghost nodes
 		bx = bx & domain;  // Take intersection of box and the problem domain
-			
-		amrex::Array4<T> const& C                 = (*(model[amrlev][mglev])).array(mfi);
+
 		amrex::Array4<const amrex::Real> const& U = a_u.array(mfi);
 		amrex::Array4<amrex::Real> const& F       = a_f.array(mfi);
 
-		const Dim3 lo= amrex::lbound(domain), hi = amrex::ubound(domain);
+		// Single precision constants are unpacked node by node, so that only the
+		// floats are read (a gathered box of models would be larger than the objects)
+		if (FloatModel(mglev))
+			ApplyBox(bx,domain,DX,Model::Solid::FloatArray<T>{m_float_model[amrlev][mglev]->const_array(mfi)},U,F,color);
+		else
+			ApplyBox(bx,domain,DX,ModelArray(amrlev,mglev,mfi,bx,cbuf),U,F,color);
+	}
+}
+
+template<class T>
+template<class M>
+void
+Elastic<T>::ApplyBox (const Box &bx, const Box &domain, const Real *DX, const M &C,
+		      const amrex::Array4<const amrex::Real> &U, const amrex::Array4<amrex::Real> &F, int color) const
+{
+	const Dim3 lo= amrex::lbound(domain), hi = amrex::ubound(domain);
+
+	amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+
+			if (color >= 0 && NodeColor(i,j,k) != color) return;
+				
+			Set::Vector f = Set::Vector::Zero();
+
+			Set::Vector u;
+			for (int p = 0; p < AMREX_SPACEDIM; p++) u(p) = U(i,j,k,p);
 			
-		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
-					
-				Set::Vector f = Set::Vector::Zero();
 
-				Set::Vector u;
-				for (int p = 0; p < AMREX_SPACEDIM; p++) u(p) = U(i,j,k,p);
+			bool AMREX_D_DECL(xmin = (i == lo.x), ymin = (j==lo.y), zmin = (k==lo.z)),
+				 AMREX_D_DECL(xmax = (i == hi.x), ymax = (j==hi.y), zmax = (k==hi.z));
+
+			// Determine if a special stencil will be necessary for first derivatives
+			std::array<Numeric::StencilType,AMREX_SPACEDIM>
+				sten = Numeric::GetStencil(i,j,k,domain);
+
+			// The displacement gradient tensor
+			Set::Matrix gradu; // gradu(i,j) = u_{i,j)
+
+			// Fill gradu
+			for (int p = 0; p < AMREX_SPACEDIM; p++)
+			{
+ 					AMREX_D_TERM(gradu(p,0) = (Numeric::Stencil<Set::Scalar,1,0,0>::D(U,i,j,k,p,DX,sten));,
+				 	     gradu(p,1) = (Numeric::Stencil<Set::Scalar,0,1,0>::D(U,i,j,k,p,DX,sten));,
+				 	     gradu(p,2) = (Numeric::Stencil<Set::Scalar,0,0,1>::D(U,i,j,k,p,DX,sten)););
+			}
 				
+			// The model at this node: a reference into the fab, or unpacked from floats
+			auto &&Cn = C(i,j,k);
 
-				bool AMREX_D_DECL(xmin = (i == lo.x), ymin = (j==lo.y), zmin = (k==lo.z)),
-					 AMREX_D_DECL(xmax = (i == hi.x), ymax = (j==hi.y), zmax = (k==hi.z));
+			// Stress tensor computed using the model fab
+			Set::Matrix sig = Cn(gradu,m_homogeneous);
 
-				// Determine if a special stencil will be necessary for first derivatives
-				std::array<Numeric::StencilType,AMREX_SPACEDIM>
-					sten = Numeric::GetStencil(i,j,k,domain);
+			// Boundary conditions
+			/// \todo Important: we need a way to handle corners and edges.
+			amrex::IntVect m(AMREX_D_DECL(i,j,k));
+			if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
+			{
+				f = (*m_bc)(u,gradu,sig,i,j,k,domain);
+			}
+			else
+			{
+				
 
-				// The displacement gradient tensor
-				Set::Matrix gradu; // gradu(i,j) = u_{i,j)
+				// The gradient of the displacement gradient tensor
+				Set::Matrix3 gradgradu; // gradgradu[k](l,j) = u_{k,lj}
 
-				// Fill gradu
+				// Fill gradu and gradgradu
 				for (int p = 0; p < AMREX_SPACEDIM; p++)
 				{
- 					AMREX_D_TERM(gradu(p,0) = (Numeric::Stencil<Set::Scalar,1,0,0>::D(U,i,j,k,p,DX,sten));,
-					 	     gradu(p,1) = (Numeric::Stencil<Set::Scalar,0,1,0>::D(U,i,j,k,p,DX,sten));,
-					 	     gradu(p,2) = (Numeric::Stencil<Set::Scalar,0,0,1>::D(U,i,j,k,p,DX,sten)););
+					// Diagonal terms:
+					AMREX_D_TERM(gradgradu(p,0,0) = (Numeric::Stencil<Set::Scalar,2,0,0>::D(U,i,j,k,p,DX));,
+						     gradgradu(p,1,1) = (Numeric::Stencil<Set::Scalar,0,2,0>::D(U,i,j,k,p,DX));,
+						     gradgradu(p,2,2) = (Numeric::Stencil<Set::Scalar,0,0,2>::D(U,i,j,k,p,DX)););
+
+					// Off-diagonal terms:
+					AMREX_D_TERM(,// 2D
+						     gradgradu(p,0,1) = (Numeric::Stencil<Set::Scalar,1,1,0>::D(U, i,j,k,p, DX));
+						     gradgradu(p,1,0) = gradgradu(p,0,1);
+						     ,// 3D
+						     gradgradu(p,0,2) = (Numeric::Stencil<Set::Scalar,1,0,1>::D(U, i,j,k,p, DX));
+						     gradgradu(p,1,2) = (Numeric::Stencil<Set::Scalar,0,1,1>::D(U, i,j,k,p, DX));
+						     gradgradu(p,2,0) = gradgradu(p,0,2);
+						     gradgradu(p,2,1) = gradgradu(p,1,2););
 				}
-					
-				// Stress tensor computed using the model fab
-				Set::Matrix sig = C(i,j,k)(gradu,m_homogeneous);
-
-				// Boundary conditions
-				/// \todo Important: we need a way to handle corners and edges.
-				amrex::IntVect m(AMREX_D_DECL(i,j,k));
-				if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
+
+				//
+				// Operator
+				//
+				// The return value is
+				//    f = C(grad grad u) + grad(C)*grad(u)
+				// In index notation
+				//    f_i = C_{ijkl,j} u_{k,l}  +  C_{ijkl}u_{k,lj}
+				//
+
+				f = Cn(gradgradu,m_homogeneous);
+
+				if (!m_uniform)
 				{
-					f = (*m_bc)(u,gradu,sig,i,j,k,domain);
+					// Central differences (this is an interior node), written out so that
+					// C need not be an Array4
+					T AMREX_D_DECL(Cgrad1 = (C(i+1,j,k) - C(i-1,j,k))*0.5 / DX[0],
+						       Cgrad2 = (C(i,j+1,k) - C(i,j-1,k))*0.5 / DX[1],
+						       Cgrad3 = (C(i,j,k+1) - C(i,j,k-1))*0.5 / DX[2]);
+					f += AMREX_D_TERM(Cgrad1(gradu,m_homogeneous).col(0),
+									 +Cgrad2(gradu,m_homogeneous).col(1),
+									 +Cgrad3(gradu,m_homogeneous).col(2));
 				}
-				else
-				{
-					
+			}
+			AMREX_D_TERM(F(i,j,k,0) = f[0];, F(i,j,k,1) = f[1];, F(i,j,k,2) = f[2];);
+		});
+}
+
 
-					// The gradient of the displacement gradient tensor
-					Set::Matrix3 gradgradu; // gradgradu[k](l,j) = u_{k,lj}
 
-					// Fill gradu and gradgradu
+template<class T>
+void
+Elastic<T>::ApplyUniform (int amrlev, int mglev, MultiFab& a_f, const MultiFab& a_u, int color) const
+{
+	BL_PROFILE("Operator::Elastic::ApplyUniform()");
+
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+
+	const Real* DX = m_geom[amrlev][mglev].CellSize();
+
+	const std::vector<Set::Scalar> &weights = m_uniform_weights[amrlev][mglev];
+	if (weights.empty()) Util::Abort(INFO,"Uniform stencil weights not computed on amrlev=",amrlev,", mglev=",mglev);
+	const Set::Scalar *W = weights.data();
+
+	// Local copy so that the boundary rows can call the model without touching the member
+	T C = m_uniform_model;
+	const T *Cp = &C;
+
+	for (MFIter mfi(a_f, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		Box bx = mfi.tilebox();
+		bx.grow(1);        // Expand to cover first layer of ghost nodes
+		bx = bx & domain;  // Take intersection of box and the problem domain
+
+		amrex::Array4<const amrex::Real> const& U = a_u.array(mfi);
+		amrex::Array4<amrex::Real> const& F       = a_f.array(mfi);
+
+		const Dim3 lo= amrex::lbound(domain), hi = amrex::ubound(domain);
+
+		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+
+				if (color >= 0 && NodeColor(i,j,k) != color) return;
+
+				bool AMREX_D_DECL(xmin = (i == lo.x), ymin = (j==lo.y), zmin = (k==lo.z)),
+					 AMREX_D_DECL(xmax = (i == hi.x), ymax = (j==hi.y), zmax = (k==hi.z));
+
+				if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin))
+				{
+					std::array<Numeric::StencilType,AMREX_SPACEDIM>
+						sten = Numeric::GetStencil(i,j,k,domain);
+
+					Set::Vector u;
+					Set::Matrix gradu;
 					for (int p = 0; p < AMREX_SPACEDIM; p++)
 					{
-						// Diagonal terms:
-						AMREX_D_TERM(gradgradu(p,0,0) = (Numeric::Stencil<Set::Scalar,2,0,0>::D(U,i,j,k,p,DX));,
-							     gradgradu(p,1,1) = (Numeric::Stencil<Set::Scalar,0,2,0>::D(U,i,j,k,p,DX));,
-							     gradgradu(p,2,2) = (Numeric::Stencil<Set::Scalar,0,0,2>::D(U,i,j,k,p,DX)););
-
-						// Off-diagonal terms:
-						AMREX_D_TERM(,// 2D
-							     gradgradu(p,0,1) = (Numeric::Stencil<Set::Scalar,1,1,0>::D(U, i,j,k,p, DX));
-							     gradgradu(p,1,0) = gradgradu(p,0,1);
-							     ,// 3D
-							     gradgradu(p,0,2) = (Numeric::Stencil<Set::Scalar,1,0,1>::D(U, i,j,k,p, DX));
-							     gradgradu(p,1,2) = (Numeric::Stencil<Set::Scalar,0,1,1>::D(U, i,j,k,p, DX));
-							     gradgradu(p,2,0) = gradgradu(p,0,2);
-							     gradgradu(p,2,1) = gradgradu(p,1,2););
+						u(p) = U(i,j,k,p);
+						AMREX_D_TERM(gradu(p,0) = (Numeric::Stencil<Set::Scalar,1,0,0>::D(U,i,j,k,p,DX,sten));,
+							     gradu(p,1) = (Numeric::Stencil<Set::Scalar,0,1,0>::D(U,i,j,k,p,DX,sten));,
+							     gradu(p,2) = (Numeric::Stencil<Set::Scalar,0,0,1>::D(U,i,j,k,p,DX,sten)););
 					}
-	
-					//
-					// Operator
-					//
-					// The return value is
-					//    f = C(grad grad u) + grad(C)*grad(u)
-					// In index notation
-					//    f_i = C_{ijkl,j} u_{k,l}  +  C_{ijkl}u_{k,lj}
-					//
-
-					f = C(i,j,k)(gradgradu,m_homogeneous);
-
-					if (!m_uniform)
+					Set::Matrix sig = (*Cp)(gradu,m_homogeneous);
+					Set::Vector f = (*m_bc)(u,gradu,sig,i,j,k,domain);
+					for (int r = 0; r < AMREX_SPACEDIM; r++) F(i,j,k,r) = f(r);
+					return;
+				}
+
+				// Interior: f_r = sum_o sum_p W(o,r,p) u_p(x+o)
+				Set::Scalar f[AMREX_SPACEDIM] = {AMREX_D_DECL(0.0,0.0,0.0)};
+				int o = 0;
+#if AMREX_SPACEDIM > 2
+				for (int dk = -1; dk <= 1; dk++)
+#else
+				const int dk = 0;
+#endif
+				for (int dj = -1; dj <= 1; dj++)
+				for (int di = -1; di <= 1; di++, o++)
+				{
+					for (int p = 0; p < AMREX_SPACEDIM; p++)
 					{
-						T AMREX_D_DECL(Cgrad1 = (Numeric::Stencil<T,1,0,0>::D(C,i,j,k,0,DX,sten)),
-							       Cgrad2 = (Numeric::Stencil<T,0,1,0>::D(C,i,j,k,0,DX,sten)),
-							       Cgrad3 = (Numeric::Stencil<T,0,0,1>::D(C,i,j,k,0,DX,sten)));
-						f += AMREX_D_TERM(Cgrad1(gradu,m_homogeneous).col(0),
-										 +Cgrad2(gradu,m_homogeneous).col(1),
-										 +Cgrad3(gradu,m_homogeneous).col(2));
+						const Set::Scalar up = U(i+di,j+dj,k+dk,p);
+						for (int r = 0; r < AMREX_SPACEDIM; r++)
+							f[r] += W[(o*AMREX_SPACEDIM + r)*AMREX_SPACEDIM + p] * up;
 					}
 				}
-				AMREX_D_TERM(F(i,j,k,0) = f[0];, F(i,j,k,1) = f[1];, F(i,j,k,2) = f[2];);
+				for (int r = 0; r < AMREX_SPACEDIM; r++) F(i,j,k,r) = f[r];
 			});
 	}
 }
 
+template<class T>
+void
+Elastic<T>::UniformWeights (int amrlev, int mglev)
+{
+	BL_PROFILE("Operator::Elastic::UniformWeights()");
+
+	// The interior operator is f = C(grad grad u), which is linear in u and uses
+	// the same weights at every node, so probe it once on a 3^dim patch.
+	const Real* DX = m_geom[amrlev][mglev].CellSize();
+	const int noff = AMREX_D_TERM(3,*3,*3);
+
+	std::vector<Set::Scalar> &w = m_uniform_weights[amrlev][mglev];
+	w.assign(noff*AMREX_SPACEDIM*AMREX_SPACEDIM, 0.0);
 
+	amrex::Box patch_box(amrex::IntVect(AMREX_D_DECL(-1,-1,-1)), amrex::IntVect(AMREX_D_DECL(1,1,1)));
+	amrex::FArrayBox patch(patch_box, AMREX_SPACEDIM);
+	amrex::Array4<const Set::Scalar> const& U = patch.const_array();
+
+	int o = 0;
+#if AMREX_SPACEDIM > 2
+	for (int dk = -1; dk <= 1; dk++)
+#endif
+	for (int dj = -1; dj <= 1; dj++)
+	for (int di = -1; di <= 1; di++, o++)
+	{
+		for (int p = 0; p < AMREX_SPACEDIM; p++)
+		{
+			patch.setVal(0.0);
+			patch(amrex::IntVect(AMREX_D_DECL(di,dj,dk)),p) = 1.0;
+
+			Set::Matrix3 gradgradu;
+			for (int q = 0; q < AMREX_SPACEDIM; q++) gradgradu[q] = Numeric::Hessian(U,0,0,0,q,DX);
+
+			Set::Vector f = m_uniform_model(gradgradu,m_homogeneous);
+			for (int r = 0; r < AMREX_SPACEDIM; r++) w[(o*AMREX_SPACEDIM + r)*AMREX_SPACEDIM + p] = f(r);
+		}
+	}
+}
 
 template<class T>
 void
 Elastic<T>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 {
 	BL_PROFILE("Operator::Elastic::Diagonal()");
+	// Recompute only boxes near changed models if the stored diagonal was otherwise current
+	const bool partial = (&a_diag == m_diag[amrlev][mglev].get()) && Partial(amrlev,m_diag_version[amrlev][mglev]);
+	SelfCoupling(amrlev,mglev,a_diag,false,partial ? &m_dirty[amrlev][mglev] : nullptr);
+}
+
+template<class T>
+void
+Elastic<T>::Block (int amrlev, int mglev, MultiFab& a_block)
+{
+	BL_PROFILE("Operator::Elastic::Block()");
+	SelfCoupling(amrlev,mglev,a_block,true);
+}
+
+template<class T>
+void
+Elastic<T>::SelfCoupling (int amrlev, int mglev, MultiFab& a_out, bool a_block, const std::vector<int> *a_dirty)
+{
+	BL_PROFILE("Operator::Elastic::SelfCoupling()");
+
+	// Column p of the nodal block is obtained by evaluating Fapply's stencil at
+	// node (i,j,k) for a unit displacement e_p at that node only. The model is
+	// probed through its operator() so that the stencil weights are contracted
+	// with the tangent exactly as in Fapply.
 
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
 	const Real* DX = m_geom[amrlev][mglev].CellSize();
+
+	T Cuniform = m_uniform_model;
+	T *Cu = m_uniform ? &Cuniform : nullptr;
+	TArrayBox cbuf;
 	
-	for (MFIter mfi(a_diag, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	for (MFIter mfi(a_out, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
+		if (a_dirty && !(*a_dirty)[mfi.index()]) continue;
+
 		Box bx = mfi.validbox();
 		bx.grow(1);        // Expand to cover first layer of ghost nodes
 		bx = bx & domain;  // Take intersection of box and the problem domain
 
-		amrex::Array4<T> const& C                 = (*(model[amrlev][mglev])).array(mfi);
-		amrex::Array4<amrex::Real> const& diag    = a_diag.array(mfi);
+		amrex::Array4<T> C                        = Cu ? amrex::Array4<T>() : ModelArray(amrlev,mglev,mfi,bx,cbuf);
+		amrex::Array4<amrex::Real> const& out     = a_out.array(mfi);
 
 		const Dim3 lo= amrex::lbound(domain), hi = amrex::ubound(domain);
 			
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
 
 				Set::Vector f = Set::Vector::Zero();
+				T &Cn = Cu ? *Cu : C(i,j,k);
 
 				bool    AMREX_D_DECL(xmin = (i == lo.x), ymin = (j==lo.y), zmin = (k==lo.z)),
 					    AMREX_D_DECL(xmax = (i == hi.x), ymax = (j==hi.y), zmax = (k==hi.z));
@@ -292,16 +982,11 @@ Elastic<T>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 				std::array<Numeric::StencilType,AMREX_SPACEDIM> sten
 					= Numeric::GetStencil(i,j,k,domain);
 
-
-				
-
 				Set::Matrix gradu; // gradu(i,j) = u_{i,j)
 				Set::Matrix3 gradgradu; // gradgradu[k](l,j) = u_{k,lj}
 
 				for (int p = 0; p < AMREX_SPACEDIM; p++)
 				{
-
-					diag(i,j,k,p) = 0.0;
 					for (int q = 0; q < AMREX_SPACEDIM; q++)
 					{
 						AMREX_D_TERM(gradu(q,0) = ((!xmax ? 0.0 : (p==q ? 1.0 : 0.0)) - (!xmin ? 0.0 : (p==q ? 1.0 : 0.0)))/((xmin || xmax ? 1.0 : 2.0)*DX[0]);,
@@ -321,31 +1006,33 @@ Elastic<T>::Diagonal (int amrlev, int mglev, MultiFab& a_diag)
 							     gradgradu(q,2,2) = (p==q ? -2.0 : 0.0)/DX[2]/DX[2]);
 					}
 
-					Set::Matrix sig = C(i,j,k)(gradu,m_homogeneous);
+					Set::Matrix sig = Cn(gradu,m_homogeneous);
 
-					amrex::IntVect m(AMREX_D_DECL(i,j,k));
 					if (AMREX_D_TERM(xmax || xmin, || ymax || ymin, || zmax || zmin)) 
 					{
 						Set::Vector u = Set::Vector::Zero();
 						u(p) = 1.0;
 						f = (*m_bc)(u,gradu,sig,i,j,k,domain);
-						diag(i,j,k,p) = f(p);
 					}
 					else
 					{
-						T AMREX_D_DECL(Cgrad1 = (Numeric::Stencil<T,1,0,0>::D(C,i,j,k,0,DX,sten)),
-							       Cgrad2 = (Numeric::Stencil<T,0,1,0>::D(C,i,j,k,0,DX,sten)),
-							       Cgrad3 = (Numeric::Stencil<T,0,0,1>::D(C,i,j,k,0,DX,sten)));
-
-						Set::Vector f = C(i,j,k)(gradgradu,m_homogeneous) + 
-							AMREX_D_TERM(Cgrad1(gradu,m_homogeneous).col(0),
-										+Cgrad2(gradu,m_homogeneous).col(1),
-										+Cgrad3(gradu,m_homogeneous).col(2));
+						f = Cn(gradgradu,m_homogeneous);
 
-						diag(i,j,k,p) += f(p);
+						// Consistent with Fapply: grad(C) terms only for nonuniform moduli
+						if (!m_uniform)
+						{
+							T AMREX_D_DECL(Cgrad1 = (Numeric::Stencil<T,1,0,0>::D(C,i,j,k,0,DX,sten)),
+								       Cgrad2 = (Numeric::Stencil<T,0,1,0>::D(C,i,j,k,0,DX,sten)),
+								       Cgrad3 = (Numeric::Stencil<T,0,0,1>::D(C,i,j,k,0,DX,sten)));
+							f += AMREX_D_TERM(Cgrad1(gradu,m_homogeneous).col(0),
+									 +Cgrad2(gradu,m_homogeneous).col(1),
+									 +Cgrad3(gradu,m_homogeneous).col(2));
+						}
 					}
-					if (std::isnan(diag(i,j,k,p))) Util::Abort(INFO,"diagonal is nan at (", i, ",", j , ",",k,"), amrlev=",amrlev,", mglev=",mglev);
+					if (std::isnan(f(p))) Util::Abort(INFO,"diagonal is nan at (", i, ",", j , ",",k,"), amrlev=",amrlev,", mglev=",mglev);
 
+					if (a_block) for (int r = 0; r < AMREX_SPACEDIM; r++) out(i,j,k,r*AMREX_SPACEDIM + p) = f(r);
+					else out(i,j,k,p) = f(p);
 				}
 			});
 	}
@@ -471,10 +1158,14 @@ Elastic<T>::Stress (int amrlev,
 	amrex::Box domain(m_geom[amrlev][0].Domain());
 	domain.convert(amrex::IntVect::TheNodeVector());
 
+	T Cuniform = m_uniform_model;
+	T *Cu = m_uniform ? &Cuniform : nullptr;
+	TArrayBox cbuf;
+
 	for (MFIter mfi(a_u, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
 		const Box& bx = mfi.tilebox();
-		amrex::Array4<T> const& C                 = (*(model[amrlev][0])).array(mfi);
+		amrex::Array4<T> C                        = Cu ? amrex::Array4<T>() : ModelArray(amrlev,0,mfi,bx,cbuf);
 		amrex::Array4<amrex::Real> const& sigma   = a_sigma.array(mfi);
 		amrex::Array4<const amrex::Real> const& u = a_u.array(mfi);
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k)
@@ -492,7 +1183,7 @@ Elastic<T>::Stress (int amrlev,
 						      		 gradu(p,2) = (Numeric::Stencil<Set::Scalar,0,0,1>::D(u, i,j,k,p, DX, sten)););
 					    }
 					 
-					    Set::Matrix sig = C(i,j,k)(gradu,m_homogeneous);
+					    Set::Matrix sig = (Cu ? *Cu : C(i,j,k))(gradu,m_homogeneous);
 
 					    if (voigt)
 					    {
@@ -533,10 +1224,14 @@ Elastic<T>::Energy (int amrlev,
 
 	const amrex::Real* DX = m_geom[amrlev][0].CellSize();
 
+	T Cuniform = m_uniform_model;
+	T *Cu = m_uniform ? &Cuniform : nullptr;
+	TArrayBox cbuf;
+
 	for (MFIter mfi(a_u, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
 		const Box& bx = mfi.tilebox();
-		amrex::Array4<T> const& C                  = (*(model[amrlev][0])).array(mfi);
+		amrex::Array4<T> C                         = Cu ? amrex::Array4<T>() : ModelArray(amrlev,0,mfi,bx,cbuf);
 		amrex::Array4<amrex::Real> const& energy   = a_energy.array(mfi);
 		amrex::Array4<const amrex::Real> const& u  = a_u.array(mfi);
 		amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k)
@@ -554,12 +1249,13 @@ Elastic<T>::Energy (int amrlev,
 						     		 gradu(p,2) = (Numeric::Stencil<Set::Scalar,0,0,1>::D(u, i,j,k,p, DX, sten)););
 					    }
 
+					    T &Cn = Cu ? *Cu : C(i,j,k);
 					 	Set::Matrix eps = .5 * (gradu + gradu.transpose());
-					    Set::Matrix sig = C(i,j,k)(gradu,m_homogeneous);
+					    Set::Matrix sig = Cn(gradu,m_homogeneous);
 
 					    // energy(i,j,k) = (gradu.transpose() * sig).trace();
 						
-						energy(i,j,k) = C(i,j,k).W(gradu);
+						energy(i,j,k) = Cn.W(gradu);
 						for (int m = 0; m < AMREX_SPACEDIM; m++)
 						{
 							for(int n = 0; n < AMREX_SPACEDIM; n++)
@@ -617,106 +1313,298 @@ Elastic<T>::Energy (int amrlev, amrex::MultiFab& a_energies, const amrex::MultiF
 
 
 
+template<class T>
+Set::Matrix
+Elastic<T>::AverageStrain (const amrex::Vector<const amrex::MultiFab*>& a_u) const
+{
+	BL_PROFILE("Operator::Elastic::AverageStrain()");
+	amrex::Vector<amrex::MultiFab> eps(a_u.size());
+	for (int lev = 0; lev < (int)a_u.size(); lev++)
+	{
+		eps[lev].define(a_u[lev]->boxArray(), a_u[lev]->DistributionMap(), AMREX_SPACEDIM*AMREX_SPACEDIM, 0);
+		Strain(lev, eps[lev], *a_u[lev]);
+	}
+	return VolumeAverage(eps);
+}
+
+template<class T>
+Set::Matrix
+Elastic<T>::AverageStress (const amrex::Vector<const amrex::MultiFab*>& a_u, bool a_homogeneous)
+{
+	BL_PROFILE("Operator::Elastic::AverageStress()");
+	amrex::Vector<amrex::MultiFab> sigma(a_u.size());
+	for (int lev = 0; lev < (int)a_u.size(); lev++)
+	{
+		sigma[lev].define(a_u[lev]->boxArray(), a_u[lev]->DistributionMap(), AMREX_SPACEDIM*AMREX_SPACEDIM, 0);
+		Stress(lev, sigma[lev], *a_u[lev], false, a_homogeneous);
+	}
+	return VolumeAverage(sigma);
+}
+
+template<class T>
+Set::Matrix
+Elastic<T>::VolumeAverage (const amrex::Vector<amrex::MultiFab>& a_field) const
+{
+	std::vector<Set::Scalar> sum = Integrate(amrex::GetVecOfConstPtrs(a_field));
+	const amrex::RealBox &rb = m_geom[0][0].ProbDomain();
+	const Set::Scalar vol = AMREX_D_TERM(rb.length(0),*rb.length(1),*rb.length(2));
+	Set::Matrix ret;
+	for (int p = 0; p < AMREX_SPACEDIM; p++)
+		for (int q = 0; q < AMREX_SPACEDIM; q++)
+			ret(p,q) = sum[p*AMREX_SPACEDIM + q] / vol;
+	return ret;
+}
+
+template<class T>
+std::vector<Set::Scalar>
+Elastic<T>::Integrate (const amrex::Vector<const amrex::MultiFab*>& a_field) const
+{
+	BL_PROFILE("Operator::Elastic::Integrate()");
+	const int nlevs = a_field.size();
+	const int ncomp = a_field[0]->nComp();
+	std::vector<Set::Scalar> sum(ncomp,0.0);
+
+	for (int lev = 0; lev < nlevs; lev++)
+	{
+		// Flag the cells of this level that are covered by the next finer one
+		amrex::BoxArray cba = amrex::convert(a_field[lev]->boxArray(), amrex::IntVect::TheCellVector());
+		amrex::iMultiFab covered(cba, a_field[lev]->DistributionMap(), 1, 0);
+		covered.setVal(0);
+		if (lev+1 < nlevs)
+		{
+			amrex::BoxArray fba = amrex::convert(a_field[lev+1]->boxArray(), amrex::IntVect::TheCellVector());
+			fba.coarsen(AMRRefRatio(lev));
+			for (MFIter mfi(covered); mfi.isValid(); ++mfi)
+				for (const auto &isect : fba.intersections(mfi.validbox()))
+					covered[mfi].setVal(1, isect.second);
+		}
+
+		const Set::Scalar *DX = m_geom[lev][0].CellSize();
+		const Set::Scalar dv = AMREX_D_TERM(DX[0],*DX[1],*DX[2]);
+		const int ncorners = 1 << AMREX_SPACEDIM;
+
+		// Each cell contributes the mean of its corner values times its volume
+		for (MFIter mfi(covered); mfi.isValid(); ++mfi)
+		{
+			const Box &bx = mfi.validbox();
+			amrex::Array4<const int> const &c                 = covered.const_array(mfi);
+			amrex::Array4<const Set::Scalar> const &f         = a_field[lev]->const_array(mfi);
+			const Dim3 lo = amrex::lbound(bx), hi = amrex::ubound(bx);
+			for (int k = lo.z; k <= hi.z; k++)
+				for (int j = lo.y; j <= hi.y; j++)
+					for (int i = lo.x; i <= hi.x; i++)
+					{
+						if (c(i,j,k)) continue;
+						for (int n = 0; n < ncomp; n++)
+						{
+							Set::Scalar val = 0.0;
+							for (int m = 0; m < ncorners; m++)
+								val += f(i + (m&1), j + ((m>>1)&1), k + ((m>>2)&1), n);
+							sum[n] += val * dv / ncorners;
+						}
+					}
+		}
+	}
+
+	amrex::ParallelDescriptor::ReduceRealSum(sum.data(), ncomp);
+	return sum;
+}
+
 template<class T>
 void
 Elastic<T>::averageDownCoeffs ()
 {
 	BL_PROFILE("Elastic::averageDownCoeffs()");
-	
-	// for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
-	// {
-	// 	for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
-	// 	{
-	// 		///\todo replace number of ghost cells with 0
-	// 		///\todo I think we can erase this section.
-	// 		model[amrlev][mglev].reset(new amrex::FabArray<amrex::BaseFab<T> >(m_grids[amrlev][mglev], m_dmap[amrlev][mglev], 1, 1));
-	// 	}
-	// }
 
-	for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
+	// Levels whose coefficients have not changed since they were last averaged are
+	// reused as they are.
+	if (m_uniform)
 	{
-		averageDownCoeffsSameAmrLevel(amrlev);
-	 	averageDownCoeffsToCoarseAmrLevel(amrlev);
+		// No hierarchy to average: just evaluate the constant stencil on each level
+		for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+		{
+			if (m_average_version[amrlev] == m_coeffs_version[amrlev]) continue;
+			for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+				UniformWeights(amrlev,mglev);
+			m_average_version[amrlev] = m_coeffs_version[amrlev];
+		}
+		return;
 	}
 
-	averageDownCoeffsSameAmrLevel(0);
-	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	MarkDirty();
+	
+	// Finest to coarsest: each AMR level is averaged over its own mg levels, and
+	// its finest mg level is then restricted onto the AMR level below it.
+	for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
 	{
-	 	for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
-	 	{
-	 		if (model[amrlev][mglev]) {
-	 			FillBoundaryCoeff(*model[amrlev][mglev], m_geom[amrlev][mglev]);
-	 		}
-	 	}
+		if (m_average_version[amrlev] != m_coeffs_version[amrlev])
+			averageDownCoeffsSameAmrLevel(amrlev);
+		if (m_average_version[amrlev-1] != m_coeffs_version[amrlev-1])
+		 	averageDownCoeffsToCoarseAmrLevel(amrlev);
 	}
+
+	if (m_average_version[0] != m_coeffs_version[0])
+		averageDownCoeffsSameAmrLevel(0);
+
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+		m_average_version[amrlev] = m_coeffs_version[amrlev];
 }
 
 template<class T>
 void
-Elastic<T>::averageDownCoeffsToCoarseAmrLevel (int /*flev*/) 
+Elastic<T>::averageDownCoeffsToCoarseAmrLevel (int flev) 
 {
-	/*
 	BL_PROFILE("Operator::Elastic::averageDownCoeffsToCoarseAmrLevel()");
 
-	//const int mglev = 0;
+	if (!m_average_down_amr) return;
+	if (m_amr_ref_ratio[flev-1] != 2) Util::Abort(INFO,"Coefficient averaging requires ref_ratio=2, got ",m_amr_ref_ratio[flev-1]);
 
-	// const int idim = 0;  // other dimensions are just aliases
+	// Replace the coarse coefficients underneath level flev with the restriction of
+	// the fine ones, so that the coarse correction sees the same material as the
+	// fine level. The fine ghost nodes are up to date (averageDownCoeffsSameAmrLevel
+	// has been called on flev), so the restriction is done on the fine distribution
+	// and then copied to the coarse one.
+	amrex::Box cdomain(m_geom[flev-1][0].Domain());
+	cdomain.convert(amrex::IntVect::TheNodeVector());
+	const Dim3 lo= amrex::lbound(cdomain), hi = amrex::ubound(cdomain);
+	const amrex::Periodicity period = m_geom[flev-1][0].periodicity();
 
-	// // amrex::average_down(*m_sigma[flev][mglev][idim], *m_sigma[flev-1][mglev][idim], 0, 1,
-	// // 		    m_amr_ref_ratio[flev-1]);
+	if (m_packed || m_indexed)
+	{
+		const amrex::MultiFab& fine = *m_packed_model[flev][0];
+		amrex::MultiFab& crse = *m_packed_model[flev-1][0];
+		const int ncomp = crse.nComp();
 
-	int ncomp = AMREX_SPACEDIM;
-	MultiTab finemt;
-	MultiTab crsemt;
-	
-	
+		BoxArray crseba = fine.boxArray();
+		crseba.coarsen(2);
+		amrex::MultiFab crse_on_fineba(crseba,fine.DistributionMap(),ncomp,0);
 
-	amrex::BoxArray fineBACoarsened = finemt.boxArray(); fineBACoarsened.coarsen(m_amr_ref_ratio[flev-1]);
+		for (MFIter mfi(crse_on_fineba, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			Box bx = mfi.tilebox() & cdomain;
 
+			amrex::Array4<const Set::Scalar> const& fdata = fine.array(mfi);
+			amrex::Array4<Set::Scalar> const& cdata       = crse_on_fineba.array(mfi);
 
-	//MultiFab crse_S_fine(crse_S_fine_BA, S_fine.DistributionMap(), ncomp, 0, MFInfo(), FArrayBoxFactory());
-        if ((fineBACoarsened == crsemt.boxArray()) &&
-	    (finemt.DistributionMap() == crsemt.DistributionMap()))
-	{
-		Util::Message(INFO); // this never seems to happen
+			if (m_indexed)
+			{
+				const int nslots = m_nslots;
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int I, int J, int K) {
+						RestrictSlots(fdata,nslots,cdata,I,J,K,lo,hi);
+					});
+				continue;
+			}
+			amrex::ParallelFor (bx,ncomp,[=] AMREX_GPU_DEVICE(int I, int J, int K, int n) {
+					cdata(I,J,K,n) = RestrictNode(fdata,n,I,J,K,lo,hi);
+				});
+		}
+		crse.ParallelCopy(crse_on_fineba,0,0,ncomp,0,0,period);
 	}
 	else
 	{
-		//Util::Abort(INFO, "difference in box arrays");
+		const MultiTab& fine = *model[flev][0];
+		MultiTab& crse = *model[flev-1][0];
 
-		MultiTab finemtcoarsened(fineBACoarsened, finemt.DistributionMap(), ncomp, 0);
+		BoxArray crseba = fine.boxArray();
+		crseba.coarsen(2);
+		MultiTab crse_on_fineba;
+		crse_on_fineba.define(crseba,fine.DistributionMap(),1,0);
 
-// #ifdef _OPENMP
-// #pragma omp parallel
-// #endif
-		for (MFIter mfi(finemtcoarsened,true); mfi.isValid(); ++mfi)
+		for (MFIter mfi(crse_on_fineba, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 		{
-			//  NOTE: The tilebox is defined at the coarse level.
-			const Box& bx = mfi.tilebox();
-                
-			const TArrayBox &fine = finemtcoarsened[mfi];
-			TArrayBox &crse = crsemt[mfi];
+			Box bx = mfi.tilebox() & cdomain;
 
-			//  NOTE: We copy from component scomp of the fine fab into component 0 of the crse fab
-			//        because the crse fab is a temporary which was made starting at comp 0, it is
-			//        not part of the actual crse multifab which came in.
+			amrex::Array4<const T> const& fdata = fine.array(mfi);
+			amrex::Array4<T> const& cdata       = crse_on_fineba.array(mfi);
 
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int I, int J, int K) {
+					cdata(I,J,K) = RestrictNode(fdata,0,I,J,K,lo,hi);
+				});
+		}
+		crse.ParallelCopy(crse_on_fineba,0,0,1,0,0,period);
+	}
+}
 
-			AMREX_D_TERM(for (int m1 = bx.loVect()[0]-1; m1<=bx.hiVect()[0]+1; m1++),
-				     for (int m2 = bx.loVect()[1]-1; m2<=bx.hiVect()[1]+1; m2++),
-				     for (int m3 = bx.loVect()[2]-1; m3<=bx.hiVect()[2]+1; m3++))
-			{
-				amrex::IntVect m_crse(AMREX_D_DECL(m1,m2,m3));
-				amrex::IntVect m_fine(AMREX_D_DECL(m1*2,m2*2,m3*2));
+template<class T>
+template<class A>
+AMREX_FORCE_INLINE
+auto
+Elastic<T>::RestrictNode (const A &fdata, int n, int I, int J, int K, const Dim3 &lo, const Dim3 &hi)
+	-> typename std::decay<decltype(fdata(0,0,0,0))>::type
+{
+	// I,J,K == coarse coordinates
+	// i,j,k == fine coordinates
+	int i=2*I, j=2*J, k=2*K;
+
+	if ((I == lo.x || I == hi.x) &&
+	    (J == lo.y || J == hi.y) &&
+	    (K == lo.z || K == hi.z)) // Corner
+		return fdata(i,j,k,n);
+	else if ((J == lo.y || J == hi.y) &&
+		 (K == lo.z || K == hi.z)) // X edge
+		return fdata(i-1,j,k,n)*0.25 + fdata(i,j,k,n)*0.5 + fdata(i+1,j,k,n)*0.25;
+	else if ((K == lo.z || K == hi.z) &&
+	 	 (I == lo.x || I == hi.x)) // Y edge
+	 	return fdata(i,j-1,k,n)*0.25 + fdata(i,j,k,n)*0.5 + fdata(i,j+1,k,n)*0.25;
+	else if ((I == lo.x || I == hi.x) &&
+	 	 (J == lo.y || J == hi.y)) // Z edge
+	 	return fdata(i,j,k-1,n)*0.25 + fdata(i,j,k,n)*0.5 + fdata(i,j,k+1,n)*0.25;
+	else if (I == lo.x || I == hi.x) // X face
+	 	return
+	 		(  fdata(i,j-1,k-1,n)     + fdata(i,j,k-1,n)*2.0 + fdata(i,j+1,k-1,n)
+	 		 + fdata(i,j-1,k  ,n)*2.0 + fdata(i,j,k  ,n)*4.0 + fdata(i,j+1,k  ,n)*2.0 
+	 		 + fdata(i,j-1,k+1,n)     + fdata(i,j,k+1,n)*2.0 + fdata(i,j+1,k+1,n)    )/16.0;
+	else if (J == lo.y || J == hi.y) // Y face
+	 	return
+	 		(  fdata(i-1,j,k-1,n)     + fdata(i-1,j,k,n)*2.0 + fdata(i-1,j,k+1,n)
+	 		 + fdata(i  ,j,k-1,n)*2.0 + fdata(i  ,j,k,n)*4.0 + fdata(i  ,j,k+1,n)*2.0 
+	 		 + fdata(i+1,j,k-1,n)     + fdata(i+1,j,k,n)*2.0 + fdata(i+1,j,k+1,n))/16.0;
+	else if (K == lo.z || K == hi.z) // Z face
+	 	return
+	 		(  fdata(i-1,j-1,k,n)     + fdata(i,j-1,k,n)*2.0 + fdata(i+1,j-1,k,n)
+	 		 + fdata(i-1,j  ,k,n)*2.0 + fdata(i,j  ,k,n)*4.0 + fdata(i+1,j  ,k,n)*2.0 
+	 		 + fdata(i-1,j+1,k,n)     + fdata(i,j+1,k,n)*2.0 + fdata(i+1,j+1,k,n))/16.0;
+	else // Interior
+		return
+			(fdata(i-1,j-1,k-1,n) + fdata(i-1,j-1,k+1,n) + fdata(i-1,j+1,k-1,n) + fdata(i-1,j+1,k+1,n) +
+			 fdata(i+1,j-1,k-1,n) + fdata(i+1,j-1,k+1,n) + fdata(i+1,j+1,k-1,n) + fdata(i+1,j+1,k+1,n)) / 64.0
+			+
+			(fdata(i,j-1,k-1,n) + fdata(i,j-1,k+1,n) + fdata(i,j+1,k-1,n) + fdata(i,j+1,k+1,n) +
+			 fdata(i-1,j,k-1,n) + fdata(i+1,j,k-1,n) + fdata(i-1,j,k+1,n) + fdata(i+1,j,k+1,n) +
+			 fdata(i-1,j-1,k,n) + fdata(i-1,j+1,k,n) + fdata(i+1,j-1,k,n) + fdata(i+1,j+1,k,n)) / 32.0
+			+
+			(fdata(i-1,j,k,n) + fdata(i,j-1,k,n) + fdata(i,j,k-1,n) +
+			 fdata(i+1,j,k,n) + fdata(i,j+1,k,n) + fdata(i,j,k+1,n)) / 16.0
+			+
+			fdata(i,j,k,n) / 8.0;
+}
 
-				crse(m_crse) = fine(m_fine);
-			}
-		}
-            
-		crsemt.copy(finemtcoarsened,0,0,ncomp);
+template<class T>
+AMREX_FORCE_INLINE
+void
+Elastic<T>::RestrictSlots (const amrex::Array4<const Set::Scalar> &fdata, int nslots,
+			   const amrex::Array4<Set::Scalar> &cdata, int I, int J, int K, const Dim3 &lo, const Dim3 &hi)
+{
+	// Phases in the slots of the fine nodes that the restriction can reach
+	constexpr int nmax = AMREX_D_TERM(3,*3,*3) * Model::Solid::MaxSlots;
+	int phase[nmax], nphases = 0;
+	const int i = 2*I, j = 2*J, k = 2*K;
+	for (int dk = -(AMREX_SPACEDIM > 2); dk <= (AMREX_SPACEDIM > 2); dk++)
+		for (int dj = -1; dj <= 1; dj++)
+			for (int di = -1; di <= 1; di++)
+				for (int s = 0; s < nslots; s++)
+				{
+					if (fdata(i+di,j+dj,k+dk,2*s+1) == 0.0) continue;
+					const int p = (int)fdata(i+di,j+dj,k+dk,2*s);
+					bool found = false;
+					for (int q = 0; q < nphases && !found; q++) found = (phase[q] == p);
+					if (!found) phase[nphases++] = p;
+				}
 
-	}
-	*/
+	Set::Scalar weight[nmax];
+	for (int q = 0; q < nphases; q++)
+		weight[q] = RestrictNode(Model::Solid::PhaseWeight{fdata,nslots,phase[q]},0,I,J,K,lo,hi);
+	Model::Solid::Select(weight,phase,nphases,cdata,nslots,I,J,K);
 }
 
 template<class T>
@@ -725,105 +1613,245 @@ Elastic<T>::averageDownCoeffsSameAmrLevel (int amrlev)
 {
 	BL_PROFILE("Elastic::averageDownCoeffsSameAmrLevel()");
 
- 	for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
- 	{
+	// Every mg level gets exactly one halo exchange. On the coarsest AMR level the
+	// valid nodes cover the domain, so the restriction only needs valid fine nodes:
+	// they are copied onto the coarse layout first, and the exchange of level mglev-1
+	// is only started then, so that it runs while level mglev is computed without
+	// anything reading the fine level. Finer AMR levels also need the ghost nodes
+	// outside the patches, so their exchange is completed before the copy.
+	const bool covered = (amrlev == 0);
+
+	// After a partial change only the flagged boxes are restricted, and mg levels
+	// with no flagged boxes (nor any coarser ones) are left alone entirely.
+	const bool partial = Partial(amrlev,m_average_version[amrlev]);
+	int nmglev = m_num_mg_levels[amrlev];
+	if (partial)
+		for (int mglev = 0; mglev < nmglev; ++mglev)
+			if (std::find(m_dirty[amrlev][mglev].begin(), m_dirty[amrlev][mglev].end(), 1) == m_dirty[amrlev][mglev].end())
+			{ nmglev = mglev; break; }
+	if (nmglev == 0) return;
+
+	for (int mglev = 1; mglev < nmglev; ++mglev)
+	{
+		const std::vector<int> *dirty = partial ? &m_dirty[amrlev][mglev] : nullptr;
+
 		amrex::Box cdomain(m_geom[amrlev][mglev].Domain());
 		cdomain.convert(amrex::IntVect::TheNodeVector());
-		amrex::Box fdomain(m_geom[amrlev][mglev-1].Domain());
-		fdomain.convert(amrex::IntVect::TheNodeVector());
-
-		MultiTab& crse = *model[amrlev][mglev];
-		MultiTab& fine = *model[amrlev][mglev-1];
-		
-		amrex::BoxArray crseba = crse.boxArray();
-		amrex::BoxArray fineba = fine.boxArray();
-		
-		BoxArray newba = crseba;
-		newba.refine(2);
-		MultiTab fine_on_crseba;
-		fine_on_crseba.define(newba,crse.DistributionMap(),1,4);
-		fine_on_crseba.ParallelCopy(fine,0,0,1,2,4,m_geom[amrlev][mglev].periodicity());
-
-		for (MFIter mfi(crse, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		const Dim3 lo= amrex::lbound(cdomain), hi = amrex::ubound(cdomain);
+		const amrex::Periodicity period = m_geom[amrlev][mglev].periodicity();
+
+		// All storages have the same number of ghost nodes
+		const int snghost = covered ? 0 : 2;
+		if (!covered) { FillBoundaryCoeffBegin(amrlev,mglev-1); FillBoundaryCoeffEnd(amrlev,mglev-1); }
+
+		if (FloatModel(mglev))
 		{
-			Box bx = mfi.tilebox();
-			bx = bx & cdomain;
+			// Single precision levels: the constants of the level above (packed from the
+			// models on the first of them) are restricted in double, then rounded
+			amrex::FabArray<amrex::BaseFab<float> >& crse = *m_float_model[amrlev][mglev];
+			BoxArray newba = crse.boxArray();
+			newba.refine(2);
+			if (FloatModel(mglev-1))
+			{
+				amrex::FabArray<amrex::BaseFab<float> > fine_on_crseba(newba,crse.DistributionMap(),T::NPack,4);
+				fine_on_crseba.ParallelCopy(*m_float_model[amrlev][mglev-1],0,0,T::NPack,snghost,4,period);
+				if (covered) FillBoundaryCoeffBegin(amrlev,mglev-1);
+				RestrictFloat(amrlev,mglev,fine_on_crseba,dirty);
+			}
+			else
+			{
+				amrex::MultiFab fine_on_crseba(newba,crse.DistributionMap(),T::NPack,4);
+				if (m_packed)
+					fine_on_crseba.ParallelCopy(*m_packed_model[amrlev][mglev-1],0,0,T::NPack,snghost,4,period);
+				else
+				{
+					const MultiTab &fine = *model[amrlev][mglev-1];
+					amrex::MultiFab &packed = CoeffHalo(amrlev,mglev-1);
+					Model::Solid::Scatter(fine,packed,snghost);
+					fine_on_crseba.ParallelCopy(packed,0,0,T::NPack,snghost,4,period);
+				}
+				if (covered) FillBoundaryCoeffBegin(amrlev,mglev-1);
+				RestrictFloat(amrlev,mglev,fine_on_crseba,dirty);
+			}
+		}
+		else if (m_packed || m_indexed)
+		{
+			// Same restriction, applied to each packed constant as a Real stream (or to the
+			// weight of each phase in the slots)
+			amrex::MultiFab& crse = *m_packed_model[amrlev][mglev];
+			amrex::MultiFab& fine = *m_packed_model[amrlev][mglev-1];
+			const int ncomp = crse.nComp();
+
+			BoxArray newba = crse.boxArray();
+			newba.refine(2);
+			amrex::MultiFab fine_on_crseba(newba,crse.DistributionMap(),ncomp,4);
+			fine_on_crseba.ParallelCopy(fine,0,0,ncomp,snghost,4,period);
+			if (covered) FillBoundaryCoeffBegin(amrlev,mglev-1);
+
+			for (MFIter mfi(crse, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				if (dirty && !(*dirty)[mfi.index()]) continue;
+				Box bx = mfi.tilebox();
+				bx = bx & cdomain;
 
-			amrex::Array4<const T> const& fdata = fine_on_crseba.array(mfi);
-			amrex::Array4<T> const& cdata       = crse.array(mfi);
+				amrex::Array4<const Set::Scalar> const& fdata = fine_on_crseba.array(mfi);
+				amrex::Array4<Set::Scalar> const& cdata       = crse.array(mfi);
 
-			const Dim3 lo= amrex::lbound(cdomain), hi = amrex::ubound(cdomain);
+				if (m_indexed)
+				{
+					const int nslots = m_nslots;
+					amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int I, int J, int K) {
+							RestrictSlots(fdata,nslots,cdata,I,J,K,lo,hi);
+						});
+					continue;
+				}
+				amrex::ParallelFor (bx,ncomp,[=] AMREX_GPU_DEVICE(int I, int J, int K, int n) {
+						cdata(I,J,K,n) = RestrictNode(fdata,n,I,J,K,lo,hi);
+					});
+			}
+		}
+		else
+		{
+			MultiTab& crse = *model[amrlev][mglev];
+			MultiTab& fine = *model[amrlev][mglev-1];
 
-			// I,J,K == coarse coordinates
-			// i,j,k == fine coordinates
-			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int I, int J, int K) {
-					int i=2*I, j=2*J, k=2*K;
-
-					if ((I == lo.x || I == hi.x) &&
-					    (J == lo.y || J == hi.y) &&
-					    (K == lo.z || K == hi.z)) // Corner
-						cdata(I,J,K) = fdata(i,j,k);
-					else if ((J == lo.y || J == hi.y) &&
-						 (K == lo.z || K == hi.z)) // X edge
-						cdata(I,J,K) = fdata(i-1,j,k)*0.25 + fdata(i,j,k)*0.5 + fdata(i+1,j,k)*0.25;
-					else if ((K == lo.z || K == hi.z) &&
-					 	 (I == lo.x || I == hi.x)) // Y edge
-					 	cdata(I,J,K) = fdata(i,j-1,k)*0.25 + fdata(i,j,k)*0.5 + fdata(i,j+1,k)*0.25;
-					else if ((I == lo.x || I == hi.x) &&
-					 	 (J == lo.y || J == hi.y)) // Z edge
-					 	cdata(I,J,K) = fdata(i,j,k-1)*0.25 + fdata(i,j,k)*0.5 + fdata(i,j,k+1)*0.25;
-					else if (I == lo.x || I == hi.x) // X face
-					 	cdata(I,J,K) =
-					 		(  fdata(i,j-1,k-1)     + fdata(i,j,k-1)*2.0 + fdata(i,j+1,k-1)
-					 		 + fdata(i,j-1,k  )*2.0 + fdata(i,j,k  )*4.0 + fdata(i,j+1,k  )*2.0 
-					 		 + fdata(i,j-1,k+1)     + fdata(i,j,k+1)*2.0 + fdata(i,j+1,k+1)    )/16.0;
-					else if (J == lo.y || J == hi.y) // Y face
-					 	cdata(I,J,K) =
-					 		(  fdata(i-1,j,k-1)     + fdata(i-1,j,k)*2.0 + fdata(i-1,j,k+1)
-					 		 + fdata(i  ,j,k-1)*2.0 + fdata(i  ,j,k)*4.0 + fdata(i  ,j,k+1)*2.0 
-					 		 + fdata(i+1,j,k-1)     + fdata(i+1,j,k)*2.0 + fdata(i+1,j,k+1))/16.0;
-					 else if (K == lo.z || K == hi.z) // Z face
-					 	cdata(I,J,K) =
-					 		(  fdata(i-1,j-1,k)     + fdata(i,j-1,k)*2.0 + fdata(i+1,j-1,k)
-					 		 + fdata(i-1,j  ,k)*2.0 + fdata(i,j  ,k)*4.0 + fdata(i+1,j  ,k)*2.0 
-					 		 + fdata(i-1,j+1,k)     + fdata(i,j+1,k)*2.0 + fdata(i+1,j+1,k))/16.0;
-					 else // Interior
-						 cdata(I,J,K) =
-							 (fdata(i-1,j-1,k-1) + fdata(i-1,j-1,k+1) + fdata(i-1,j+1,k-1) + fdata(i-1,j+1,k+1) +
-							  fdata(i+1,j-1,k-1) + fdata(i+1,j-1,k+1) + fdata(i+1,j+1,k-1) + fdata(i+1,j+1,k+1)) / 64.0
-							 +
-							 (fdata(i,j-1,k-1) + fdata(i,j-1,k+1) + fdata(i,j+1,k-1) + fdata(i,j+1,k+1) +
-							  fdata(i-1,j,k-1) + fdata(i+1,j,k-1) + fdata(i-1,j,k+1) + fdata(i+1,j,k+1) +
-							  fdata(i-1,j-1,k) + fdata(i-1,j+1,k) + fdata(i+1,j-1,k) + fdata(i+1,j+1,k)) / 32.0
-							 +
-							 (fdata(i-1,j,k) + fdata(i,j-1,k) + fdata(i,j,k-1) +
-							  fdata(i+1,j,k) + fdata(i,j+1,k) + fdata(i,j,k+1)) / 16.0
-							 +
-							 fdata(i,j,k) / 8.0;
-				});
+			BoxArray newba = crse.boxArray();
+			newba.refine(2);
+			MultiTab fine_on_crseba;
+			fine_on_crseba.define(newba,crse.DistributionMap(),1,4);
+			fine_on_crseba.ParallelCopy(fine,0,0,1,snghost,4,period);
+			if (covered) FillBoundaryCoeffBegin(amrlev,mglev-1);
+
+			for (MFIter mfi(crse, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				if (dirty && !(*dirty)[mfi.index()]) continue;
+				Box bx = mfi.tilebox();
+				bx = bx & cdomain;
+
+				amrex::Array4<const T> const& fdata = fine_on_crseba.array(mfi);
+				amrex::Array4<T> const& cdata       = crse.array(mfi);
+
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int I, int J, int K) {
+						cdata(I,J,K) = RestrictNode(fdata,0,I,J,K,lo,hi);
+					});
+			}
 		}
-		//fine_on_crseba.ParallelCopy(fine,0,0,1,2,4,m_geom[amrlev][mglev].periodicity());
-		//fine.ParallelCopy(fine_on_crseba,0,0,1,2,4,m_geom[amrlev][mglev].periodicity());
-		FillBoundaryCoeff(crse,m_geom[amrlev][mglev]);
+
+		if (covered) FillBoundaryCoeffEnd(amrlev,mglev-1);
+	}
+
+	FillBoundaryCoeffBegin(amrlev,nmglev-1);
+	FillBoundaryCoeffEnd(amrlev,nmglev-1);
+}
+
+template<class T>
+template<class S>
+void
+Elastic<T>::RestrictFloat (int amrlev, int mglev, const amrex::FabArray<amrex::BaseFab<S> > &a_fine_on_crseba,
+			   const std::vector<int> *a_dirty)
+{
+	amrex::FabArray<amrex::BaseFab<float> >& crse = *m_float_model[amrlev][mglev];
+
+	amrex::Box cdomain(m_geom[amrlev][mglev].Domain());
+	cdomain.convert(amrex::IntVect::TheNodeVector());
+	const Dim3 lo= amrex::lbound(cdomain), hi = amrex::ubound(cdomain);
+
+	for (MFIter mfi(crse, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		if (a_dirty && !(*a_dirty)[mfi.index()]) continue;
+		Box bx = mfi.tilebox();
+		bx = bx & cdomain;
+
+		amrex::Array4<const S> const& fdata = a_fine_on_crseba.const_array(mfi);
+		amrex::Array4<float> const& cdata   = crse.array(mfi);
+		// Read the fine constants as double, so the weighted sum is not rounded
+		auto fine = [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> Set::Scalar {
+			return static_cast<Set::Scalar>(fdata(i,j,k,n));
+		};
+
+		amrex::ParallelFor (bx,T::NPack,[=] AMREX_GPU_DEVICE(int I, int J, int K, int n) {
+				cdata(I,J,K,n) = static_cast<float>(RestrictNode(fine,n,I,J,K,lo,hi));
+			});
 	}
 }
 
 template<class T>
 void
-Elastic<T>::FillBoundaryCoeff (MultiTab& sigma, const Geometry& geom)
+Elastic<T>::FillBoundaryCoeffBegin (int amrlev, int mglev)
+{
+	BL_PROFILE("Elastic::FillBoundaryCoeffBegin()");
+
+	const amrex::Periodicity period = m_geom[amrlev][mglev].periodicity();
+
+	if (FloatModel(mglev))
+	{
+		m_float_model[amrlev][mglev]->FillBoundary_nowait(period);
+		return;
+	}
+	if (m_packed || m_indexed)
+	{
+		m_packed_model[amrlev][mglev]->FillBoundary_nowait(period);
+		return;
+	}
+
+	// Only the independent constants of each model are sent, and all ghost layers
+	// are exchanged in a single round. Ghost nodes that no valid box covers (outside
+	// the patches of a fine AMR level) keep the values they were set with.
+	MultiTab &mf = *model[amrlev][mglev];
+	amrex::MultiFab &halo = CoeffHalo(amrlev,mglev);
+	Model::Solid::Scatter(mf, halo, mf.nGrow());
+	halo.FillBoundary_nowait(period);
+}
+
+template<class T>
+void
+Elastic<T>::FillBoundaryCoeffEnd (int amrlev, int mglev)
+{
+	BL_PROFILE("Elastic::FillBoundaryCoeffEnd()");
+
+	if (FloatModel(mglev))
+	{
+		m_float_model[amrlev][mglev]->FillBoundary_finish();
+		return;
+	}
+	if (m_packed || m_indexed)
+	{
+		m_packed_model[amrlev][mglev]->FillBoundary_finish();
+		return;
+	}
+
+	amrex::MultiFab &halo = *m_coeff_halo[amrlev][mglev];
+	halo.FillBoundary_finish();
+
+	// Unpack everything that the exchange filled: nodes inside the domain,
+	// plus the periodic images.
+	MultiTab &mf = *model[amrlev][mglev];
+	const int nghost = mf.nGrow();
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	for (int d = 0; d < AMREX_SPACEDIM; d++)
+		if (m_geom[amrlev][mglev].isPeriodic(d)) domain.grow(d,nghost);
+
+	for (MFIter mfi(mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		Box bx = mfi.growntilebox(nghost) & domain;
+		Model::Solid::Gather(bx, halo.array(mfi), mf.array(mfi));
+	}
+}
+
+template<class T>
+amrex::MultiFab &
+Elastic<T>::CoeffHalo (int amrlev, int mglev)
 {
-	BL_PROFILE("Elastic::FillBoundaryCoeff()");
-	for (int i = 0; i < 2; i++)
+	const MultiTab &mf = *model[amrlev][mglev];
+	std::unique_ptr<amrex::MultiFab> &halo = m_coeff_halo[amrlev][mglev];
+	if (!halo ||
+	    halo->boxArray()        != mf.boxArray() ||
+	    halo->DistributionMap() != mf.DistributionMap())
 	{
-		MultiTab & mf = sigma;
-		mf.FillBoundary(geom.periodicity());
-		const int ncomp = mf.nComp();
-		const int ng1 = 1;
-		const int ng2 = 2;
-		MultiTab tmpmf(mf.boxArray(), mf.DistributionMap(), ncomp, ng1);
-	  	tmpmf.copy(mf,0,0,ncomp,ng2,ng1,geom.periodicity());
-		mf.ParallelCopy   (tmpmf, 0, 0, ncomp, ng1, ng2, geom.periodicity());
+		halo.reset(new amrex::MultiFab(mf.boxArray(), mf.DistributionMap(), T::NPack, mf.nGrow()));
 	}
+	return *halo;
 }
 
 // TODO : Remove these template specializations once Mobility and PD are upgraded
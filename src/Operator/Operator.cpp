@@ -3,6 +3,7 @@
 #include <AMReX_MLCellLinOp.H>
 #include <AMReX_MLNodeLap_K.H>
 #include <AMReX_MultiFabUtil.H>
+#include <limits>
 #include "Util/Color.H"
 #include "Set/Set.H"
 #include "Operator.H"
@@ -17,17 +18,37 @@ void Operator<Grid::Node>::Diagonal (bool recompute)
 {
 	BL_PROFILE(Color::FG::Yellow + "Operator::Diagonal()" + Color::Reset);
 	//Util::Message(INFO);
-	
-	if ( !recompute && m_diagonal_computed ) return;
-	m_diagonal_computed = true;
 
 	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
 	{
 		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
 		{
+			// Skip levels whose coefficients have not changed since the last call
+			if (!recompute && m_diag_version[amrlev][mglev] == m_coeffs_version[amrlev]) continue;
 			Diagonal(amrlev,mglev,*m_diag[amrlev][mglev]);
+			m_diag_version[amrlev][mglev] = m_coeffs_version[amrlev];
 		}
 	}
+	m_diagonal_computed = true;
+}
+
+void Operator<Grid::Node>::UpdateDiagonal (int amrlev, int mglev)
+{
+	if (m_diag_version[amrlev][mglev] == m_coeffs_version[amrlev]) return;
+	Diagonal(amrlev,mglev,*m_diag[amrlev][mglev]);
+	m_diag_version[amrlev][mglev] = m_coeffs_version[amrlev];
+}
+
+void Operator<Grid::Node>::CoeffsChanged (int amrlev)
+{
+	int nlevels = (int)m_coeffs_version.size(); // zero if define has not been called yet
+	if (amrlev < 0 || amrlev >= nlevels)
+	{
+		for (int lev = 0; lev < nlevels; ++lev) m_coeffs_version[lev]++;
+		return;
+	}
+	// Coarse AMR levels are averaged down from finer ones, so they change too.
+	for (int lev = 0; lev <= amrlev; ++lev) m_coeffs_version[lev]++;
 }
 
 void Operator<Grid::Node>::Diagonal (int amrlev, int mglev, amrex::MultiFab &diag)
@@ -35,54 +56,45 @@ void Operator<Grid::Node>::Diagonal (int amrlev, int mglev, amrex::MultiFab &dia
 	BL_PROFILE("Operator::Diagonal()");
 	//Util::Message(INFO);
 
+	// Fallback for operators that do not provide an analytic diagonal.
+	// Nodes are split into sep^AMREX_SPACEDIM colors such that nodes of the same
+	// color are never in each other's stencil. Each color and component is
+	// probed with a single Fapply over the whole level, so the cost is
+	// ncomp*sep^AMREX_SPACEDIM applications independent of the number of boxes.
+
 	int ncomp = diag.nComp();
-	int nghost = 0;
+	int nghost = getNGrow();
 
-	int sep = 2;
-	int num = AMREX_D_TERM(sep,*sep,*sep);
-	int cntr = 0;
+	const int sep = 2;
+	const int num = AMREX_D_TERM(sep,*sep,*sep);
 
-	amrex::MultiFab x(m_diag[amrlev][mglev]->boxArray(), m_diag[amrlev][mglev]->DistributionMap(), ncomp, nghost);
-	amrex::MultiFab Ax(m_diag[amrlev][mglev]->boxArray(), m_diag[amrlev][mglev]->DistributionMap(), ncomp, nghost);
+	amrex::MultiFab x(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+	amrex::MultiFab Ax(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
 
-	for (MFIter mfi(x, false); mfi.isValid(); ++mfi)
-	{
-		const Box& bx = mfi.validbox();
-		amrex::FArrayBox       &diagfab = diag[mfi];
-		amrex::FArrayBox       &xfab    = x[mfi];
-		amrex::FArrayBox       &Axfab   = Ax[mfi];
+	diag.setVal(0.0);
 
-		diagfab.setVal(0.0);
-				
-		for (int i = 0; i < num; i++)
+	for (int color = 0; color < num; color++)
+	{
+		for (int n = 0; n < ncomp; n++)
 		{
-			for (int n = 0; n < ncomp; n++)
+			x.setVal(0.0);
+			Ax.setVal(0.0);
+
+			for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
 			{
-				xfab.setVal(0.0);
-				Axfab.setVal(0.0);
-				
-				//BL_PROFILE_VAR("Operator::Part1", part1); 
-				AMREX_D_TERM(for (int m1 = bx.loVect()[0]; m1<=bx.hiVect()[0]; m1++),
-					     for (int m2 = bx.loVect()[1]; m2<=bx.hiVect()[1]; m2++),
-					     for (int m3 = bx.loVect()[2]; m3<=bx.hiVect()[2]; m3++))
-				{
-					amrex::IntVect m(AMREX_D_DECL(m1,m2,m3));
-				
-					if ( m1%sep == i/sep   &&   m2%sep == i%sep ) xfab(m,n) = 1.0;
-					else xfab(m,n) = 0.0;
-				}
-				//BL_PROFILE_VAR_STOP(part1);
-
-				BL_PROFILE_VAR("Operator::Part2", part2); 
-				Util::Message(INFO,"Calling fapply...",cntr++);
-				Fapply(amrlev,mglev,Ax,x);
-				BL_PROFILE_VAR_STOP(part2);
-						
-				//BL_PROFILE_VAR("Operator::Part3", part3); 
-				Axfab.mult(xfab,n,n,1);
-				diagfab.plus(Axfab,n,n,1);
-				//BL_PROFILE_VAR_STOP(part3);
+				const Box bx = mfi.growntilebox(nghost);
+				amrex::Array4<amrex::Real> const& xarr = x.array(mfi);
+				amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						int AMREX_D_DECL(ci = ((i%sep)+sep)%sep, cj = ((j%sep)+sep)%sep, ck = ((k%sep)+sep)%sep);
+						if (AMREX_D_TERM(ci, + sep*cj, + sep*sep*ck) == color) xarr(i,j,k,n) = 1.0;
+					});
 			}
+
+			Fapply(amrlev,mglev,Ax,x);
+
+			// Only the probed entries survive the multiplication by x
+			amrex::MultiFab::Multiply(Ax,x,n,n,1,nghost);
+			amrex::MultiFab::Add(diag,Ax,n,n,1,std::min(nghost,diag.nGrow()));
 		}
 	}
 }
@@ -90,6 +102,24 @@ void Operator<Grid::Node>::Diagonal (int amrlev, int mglev, amrex::MultiFab &dia
 void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
 {
 	BL_PROFILE("Operator::Fsmooth()");
+	if (m_bottom_factorized && amrlev == 0 && mglev == m_num_mg_levels[0]-1)
+	{
+		DirectBottomSolve(x,b);
+		return;
+	}
+	switch (m_smoother)
+	{
+	case Smoother::Jacobi:      FsmoothJacobi(amrlev,mglev,x,b);      break;
+	case Smoother::GaussSeidel: FsmoothGaussSeidel(amrlev,mglev,x,b); break;
+	case Smoother::Chebyshev:   FsmoothChebyshev(amrlev,mglev,x,b);   break;
+	case Smoother::BlockJacobi: FsmoothBlockJacobi(amrlev,mglev,x,b); break;
+	default: Util::Abort(INFO,"Invalid smoother");
+	}
+}
+
+void Operator<Grid::Node>::FsmoothJacobi (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
+{
+	BL_PROFILE("Operator::FsmoothJacobi()");
 
 	amrex::Box domain(m_geom[amrlev][mglev].Domain());
 
@@ -98,11 +128,10 @@ void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, c
 	
 	Set::Scalar omega = 2./3.; // Damping factor (very important!)
 
-	amrex::MultiFab Ax(x.boxArray(), x.DistributionMap(), ncomp, nghost);
-	amrex::MultiFab Dx(x.boxArray(), x.DistributionMap(), ncomp, nghost);
-	amrex::MultiFab Rx(x.boxArray(), x.DistributionMap(), ncomp, nghost);
+	amrex::MultiFab &Ax = Workspace(amrlev,mglev,ScratchApply,x);
 	
-	if (!m_diagonal_computed) Util::Abort(INFO,"Operator::Diagonal() must be called before using Fsmooth");
+	// Only the caches are modified, so casting away const is safe here (see UpdateDiagonal)
+	const_cast<Operator<Grid::Node>*>(this)->UpdateDiagonal(amrlev,mglev);
 
 	// This is a JACOBI iteration, not Gauss-Seidel.
 	// So we need to do twice the number of iterations to get the same behavior as GS.
@@ -110,19 +139,12 @@ void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, c
 	{
 		Fapply(amrlev,mglev,Ax,x); // find Ax
 
-		amrex::MultiFab::Copy(Dx,x,0,0,ncomp,nghost); // Dx = x
-		amrex::MultiFab::Multiply(Dx,*m_diag[amrlev][mglev],0,0,ncomp,nghost); // Dx *= diag  (Dx = x*diag)
-
-		amrex::MultiFab::Copy(Rx,Ax,0,0,ncomp,nghost); // Rx = Ax
-		amrex::MultiFab::Subtract(Rx,Dx,0,0,ncomp,nghost); // Rx -= Dx  (Rx = Ax - Dx)
-
 		for (MFIter mfi(x, false); mfi.isValid(); ++mfi)
 		{
 			const Box& bx = mfi.validbox();
 			amrex::FArrayBox       &xfab    = x[mfi];
 			const amrex::FArrayBox &bfab    = b[mfi];
-			//const amrex::FArrayBox &Axfab   = Ax[mfi];
-			const amrex::FArrayBox &Rxfab   = Rx[mfi];
+			const amrex::FArrayBox &Axfab   = Ax[mfi];
 			const amrex::FArrayBox &diagfab = (*m_diag[amrlev][mglev])[mfi];
 
 			for (int n = 0; n < ncomp; n++)
@@ -150,17 +172,612 @@ void Operator<Grid::Node>::Fsmooth (int amrlev, int mglev, amrex::MultiFab& x, c
 						continue;
 					}
 
-					//xfab(m,n) = xfab(m,n) + omega*(bfab(m,n) - Axfab(m,n))/diagfab(m,n);
-					xfab(m,n) = (1.-omega)*xfab(m,n) + omega*(bfab(m,n) - Rxfab(m,n))/diagfab(m,n);
+					// Equivalent to (1-omega)*x + omega*(b - (Ax - diag*x))/diag,
+					// but without needing the off-diagonal residual as a separate fab.
+					xfab(m,n) = xfab(m,n) + omega*(bfab(m,n) - Axfab(m,n))/diagfab(m,n);
 				}
 			}
 		}
 	}
 	amrex::Geometry geom = m_geom[amrlev][mglev];
-	realFillBoundary(x,geom);
+	realFillBoundary(x,geom,&Workspace(amrlev,mglev,ScratchFill,x));
 	nodalSync(amrlev, mglev, x);
 }
 
+void Operator<Grid::Node>::FsmoothGaussSeidel (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
+{
+	BL_PROFILE("Operator::FsmoothGaussSeidel()");
+
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	const amrex::Geometry &geom = m_geom[amrlev][mglev];
+
+	int ncomp = b.nComp();
+
+	amrex::MultiFab &Ax  = Workspace(amrlev,mglev,ScratchApply,x);
+	amrex::MultiFab &tmp = Workspace(amrlev,mglev,ScratchFill,x);
+
+	// Only the caches are modified, so casting away const is safe here (see UpdateDiagonal)
+	const_cast<Operator<Grid::Node>*>(this)->UpdateDiagonal(amrlev,mglev);
+
+	// Nodes of one color only depend on nodes of other colors, so each color
+	// can be relaxed simultaneously. Ghost nodes must be refreshed before
+	// moving on to the next color so that neighboring boxes see the update;
+	// the next color only reads the first ghost layer, so a plain exchange is
+	// enough in between, and the full fill is done once at the end.
+	for (int color = 0; color < NColors; color++)
+	{
+		FapplyColor(amrlev,mglev,Ax,x,color);
+
+		for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			Box bx = mfi.tilebox();
+			bx = bx & domain;
+
+			amrex::Array4<amrex::Real> const& X        = x.array(mfi);
+			amrex::Array4<const amrex::Real> const& B  = b.array(mfi);
+			amrex::Array4<const amrex::Real> const& AX = Ax.array(mfi);
+			amrex::Array4<const amrex::Real> const& D  = m_diag[amrlev][mglev]->array(mfi);
+
+			for (int n = 0; n < ncomp; n++)
+			{
+				amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						if (NodeColor(i,j,k) != color) return;
+						X(i,j,k,n) += (B(i,j,k,n) - AX(i,j,k,n))/D(i,j,k,n);
+					});
+			}
+		}
+		if (color < NColors-1) x.FillBoundary(geom.periodicity());
+	}
+	realFillBoundary(x,geom,&tmp);
+	nodalSync(amrlev, mglev, x);
+}
+
+void Operator<Grid::Node>::FsmoothChebyshev (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
+{
+	BL_PROFILE("Operator::FsmoothChebyshev()");
+
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	const amrex::Geometry &geom = m_geom[amrlev][mglev];
+
+	int ncomp = b.nComp();
+
+	// Refresh this level's estimate (and diagonal) as in UpdateDiagonal. Only the
+	// caches are modified, so casting away const is safe here.
+	if (m_lambda_version[amrlev][mglev] != m_coeffs_version[amrlev])
+		const_cast<Operator<Grid::Node>*>(this)->Eigenvalue(amrlev,mglev);
+
+	amrex::MultiFab &Ax  = Workspace(amrlev,mglev,ScratchApply,x);
+	amrex::MultiFab &d   = Workspace(amrlev,mglev,ScratchSmooth,x);
+	amrex::MultiFab &tmp = Workspace(amrlev,mglev,ScratchFill,x);
+
+	// Damp the interval [0.1,1.1]*lambda_max: the upper end is padded because the
+	// power iteration underestimates, and the lower end leaves smooth modes to the
+	// coarse grid correction.
+	const amrex::Real lambda_max = 1.1 * m_lambda_max[amrlev][mglev];
+	const amrex::Real lambda_min = 0.1 * m_lambda_max[amrlev][mglev];
+	const amrex::Real theta = 0.5*(lambda_max + lambda_min);
+	const amrex::Real delta = 0.5*(lambda_max - lambda_min);
+	const amrex::Real sigma = theta/delta;
+	amrex::Real rho_old = 1.0/sigma;
+
+	for (int iter = 0; iter < m_chebyshev_degree; iter++)
+	{
+		Fapply(amrlev,mglev,Ax,x);
+
+		// d = 1/theta D^-1 (b - Ax)                          (first iteration)
+		// d = rho*rho_old d + 2 rho/delta D^-1 (b - Ax)       (subsequent iterations)
+		amrex::Real rho = 1.0/(2.0*sigma - rho_old);
+		amrex::Real alpha = (iter == 0) ? 0.0 : rho*rho_old;
+		amrex::Real beta  = (iter == 0) ? 1.0/theta : 2.0*rho/delta;
+		if (iter > 0) rho_old = rho;
+
+		for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			Box bx = mfi.tilebox();
+			bx = bx & domain;
+
+			amrex::Array4<amrex::Real> const& X        = x.array(mfi);
+			amrex::Array4<amrex::Real> const& DIR      = d.array(mfi);
+			amrex::Array4<const amrex::Real> const& B  = b.array(mfi);
+			amrex::Array4<const amrex::Real> const& AX = Ax.array(mfi);
+			amrex::Array4<const amrex::Real> const& D  = m_diag[amrlev][mglev]->array(mfi);
+
+			for (int n = 0; n < ncomp; n++)
+			{
+				amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						amrex::Real r = (B(i,j,k,n) - AX(i,j,k,n))/D(i,j,k,n);
+						DIR(i,j,k,n) = (alpha == 0.0 ? 0.0 : alpha*DIR(i,j,k,n)) + beta*r;
+						X(i,j,k,n) += DIR(i,j,k,n);
+					});
+			}
+		}
+		realFillBoundary(x,geom,&tmp);
+	}
+	nodalSync(amrlev, mglev, x);
+}
+
+void Operator<Grid::Node>::FsmoothBlockJacobi (int amrlev, int mglev, amrex::MultiFab& x, const amrex::MultiFab& b) const
+{
+	BL_PROFILE("Operator::FsmoothBlockJacobi()");
+
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	const amrex::Geometry &geom = m_geom[amrlev][mglev];
+
+	const int ncomp = b.nComp();
+	const Set::Scalar omega = 2./3.; // Damping factor, as in the point Jacobi smoother
+
+	// Refresh this level's block inverse (and diagonal) as in UpdateDiagonal. Only the
+	// caches are modified, so casting away const is safe here.
+	const_cast<Operator<Grid::Node>*>(this)->UpdateBlockInverse(amrlev,mglev);
+
+	amrex::MultiFab &Ax  = Workspace(amrlev,mglev,ScratchApply,x);
+	amrex::MultiFab &r   = Workspace(amrlev,mglev,ScratchSmooth,x);
+	amrex::MultiFab &tmp = Workspace(amrlev,mglev,ScratchFill,x);
+
+	for (int ctr = 0; ctr < 2; ctr++)
+	{
+		Fapply(amrlev,mglev,Ax,x);
+
+		for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			Box bx = mfi.tilebox();
+			bx = bx & domain;
+
+			amrex::Array4<amrex::Real> const& X          = x.array(mfi);
+			amrex::Array4<amrex::Real> const& R          = r.array(mfi);
+			amrex::Array4<const amrex::Real> const& B    = b.array(mfi);
+			amrex::Array4<const amrex::Real> const& AX   = Ax.array(mfi);
+			amrex::Array4<const amrex::Real> const& Binv = m_block_inv[amrlev][mglev]->array(mfi);
+
+			amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					for (int n = 0; n < ncomp; n++) R(i,j,k,n) = B(i,j,k,n) - AX(i,j,k,n);
+					for (int n = 0; n < ncomp; n++)
+					{
+						amrex::Real dx = 0.0;
+						for (int m = 0; m < ncomp; m++) dx += Binv(i,j,k,n*ncomp + m) * R(i,j,k,m);
+						X(i,j,k,n) += omega * dx;
+					}
+				});
+		}
+		realFillBoundary(x,geom,&tmp);
+	}
+	nodalSync(amrlev, mglev, x);
+}
+
+void Operator<Grid::Node>::Block (int amrlev, int mglev, amrex::MultiFab& block)
+{
+	BL_PROFILE("Operator::Block()");
+	const int ncomp = getNComp();
+	const amrex::MultiFab &diag = *m_diag[amrlev][mglev];
+	block.setVal(0.0);
+	for (int n = 0; n < ncomp; n++)
+		amrex::MultiFab::Copy(block,diag,n,n*ncomp + n,1,std::min(block.nGrow(),diag.nGrow()));
+}
+
+void Operator<Grid::Node>::BlockInverse (bool recompute)
+{
+	BL_PROFILE("Operator::BlockInverse()");
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	{
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+		{
+			if (recompute && !m_block_version.empty()) m_block_version[amrlev][mglev] = -1;
+			UpdateBlockInverse(amrlev,mglev);
+		}
+	}
+}
+
+void Operator<Grid::Node>::UpdateBlockInverse (int amrlev, int mglev)
+{
+	const int ncomp = getNComp();
+	if (ncomp != AMREX_SPACEDIM) Util::Abort(INFO,"BlockJacobi requires getNComp() == AMREX_SPACEDIM");
+
+	if (m_block_inv.empty())
+	{
+		m_block_inv.resize(m_num_amr_levels);
+		m_block_version.resize(m_num_amr_levels);
+		for (int lev = 0; lev < m_num_amr_levels; ++lev)
+		{
+			m_block_inv[lev].resize(m_num_mg_levels[lev]);
+			m_block_version[lev].assign(m_num_mg_levels[lev],-1);
+		}
+	}
+	if (m_block_inv[amrlev][mglev] && m_block_version[amrlev][mglev] == m_coeffs_version[amrlev]) return;
+
+	UpdateDiagonal(amrlev,mglev);
+	const amrex::MultiFab &diag = *m_diag[amrlev][mglev];
+	if (!m_block_inv[amrlev][mglev])
+		m_block_inv[amrlev][mglev].reset(new amrex::MultiFab(diag.boxArray(), diag.DistributionMap(),
+								     ncomp*ncomp, 1));
+	amrex::MultiFab &binv = *m_block_inv[amrlev][mglev];
+
+	// The blocks are computed in place, then inverted node by node
+	binv.setVal(0.0);
+	Block(amrlev,mglev,binv);
+
+	for (MFIter mfi(binv, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		Box bx = mfi.growntilebox(1);
+		amrex::Array4<amrex::Real> const& B = binv.array(mfi);
+		amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+				Set::Matrix block;
+				for (int n = 0; n < AMREX_SPACEDIM; n++)
+					for (int m = 0; m < AMREX_SPACEDIM; m++)
+						block(n,m) = B(i,j,k,n*AMREX_SPACEDIM + m);
+				// Nodes outside the domain are never touched; leave them alone
+				if (block.isZero()) return;
+				Set::Matrix inv = block.inverse();
+				for (int n = 0; n < AMREX_SPACEDIM; n++)
+					for (int m = 0; m < AMREX_SPACEDIM; m++)
+						B(i,j,k,n*AMREX_SPACEDIM + m) = inv(n,m);
+			});
+	}
+	m_block_version[amrlev][mglev] = m_coeffs_version[amrlev];
+}
+
+bool Operator<Grid::Node>::StencilAssembled (int amrlev, int mglev) const
+{
+	if (m_assembled_mglev < 0 || mglev < m_assembled_mglev) return false;
+	if (m_stencil.empty() || !m_stencil[amrlev][mglev]) return false;
+	return m_stencil_version[amrlev][mglev] == m_coeffs_version[amrlev];
+}
+
+void Operator<Grid::Node>::AssembleStencil (bool recompute)
+{
+	BL_PROFILE("Operator::AssembleStencil()");
+	if (m_assembled_mglev < 0) return;
+
+	if (m_stencil.empty())
+	{
+		m_stencil.resize(m_num_amr_levels);
+		m_stencil_version.resize(m_num_amr_levels);
+		for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+		{
+			m_stencil[amrlev].resize(m_num_mg_levels[amrlev]);
+			m_stencil_version[amrlev].assign(m_num_mg_levels[amrlev],-1);
+		}
+	}
+
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	{
+		for (int mglev = m_assembled_mglev; mglev < m_num_mg_levels[amrlev]; ++mglev)
+		{
+			if (!recompute && StencilAssembled(amrlev,mglev)) continue;
+			if (!StencilAssemblable(amrlev,mglev))
+			{
+				if (!m_stencil_warned)
+					Util::Warning(INFO,"Assembled stencil needs periodic directions that are a multiple of 3 nodes long; using Fapply on amrlev=",amrlev,", mglev=",mglev," instead");
+				m_stencil_warned = true;
+				continue;
+			}
+			// Invalidate first: assembly probes Fapply, which must not use this stencil
+			m_stencil_version[amrlev][mglev] = -1;
+			AssembleStencil(amrlev,mglev);
+			m_stencil_version[amrlev][mglev] = m_coeffs_version[amrlev];
+		}
+	}
+}
+
+bool Operator<Grid::Node>::StencilAssemblable (int amrlev, int mglev) const
+{
+	const amrex::Geometry &geom = m_geom[amrlev][mglev];
+	for (int idim = 0; idim < AMREX_SPACEDIM; idim++)
+		if (geom.isPeriodic(idim) && geom.Domain().length(idim) % 3 != 0) return false;
+	return true;
+}
+
+void Operator<Grid::Node>::AssembleStencil (int amrlev, int mglev)
+{
+	const int ncomp = getNComp();
+	const int noff = AMREX_D_TERM(3,*3,*3);
+	if (!m_stencil[amrlev][mglev])
+		m_stencil[amrlev][mglev].reset(new amrex::MultiFab(m_diag[amrlev][mglev]->boxArray(), m_diag[amrlev][mglev]->DistributionMap(),
+								   noff*ncomp*ncomp, 1));
+	AssembleStencil(amrlev,mglev,*m_stencil[amrlev][mglev]);
+}
+
+void Operator<Grid::Node>::AssembleStencil (int amrlev, int mglev, amrex::MultiFab &stencil)
+{
+	BL_PROFILE("Operator::AssembleStencil()");
+
+	const int ncomp = getNComp();
+	const int nghost = getNGrow();
+	const int noff = AMREX_D_TERM(3,*3,*3);
+
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+
+	const amrex::BoxArray &ba = m_diag[amrlev][mglev]->boxArray();
+	const amrex::DistributionMapping &dm = m_diag[amrlev][mglev]->DistributionMap();
+
+	stencil.setVal(0.0);
+
+	amrex::MultiFab x(ba, dm, ncomp, nghost);
+	amrex::MultiFab Ax(ba, dm, ncomp, nghost);
+
+	// Probe all nodes whose index is congruent to `a` (mod 3) at once: every node
+	// has exactly one such node in its 3^AMREX_SPACEDIM neighborhood.
+	for (int a = 0; a < noff; a++)
+	{
+		const int ai = a%3, aj = (a/3)%3, ak = (a/9)%3;
+		for (int p = 0; p < ncomp; p++)
+		{
+			x.setVal(0.0);
+			Ax.setVal(0.0);
+
+			for (MFIter mfi(x, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				const Box bx = mfi.growntilebox(nghost);
+				amrex::Array4<amrex::Real> const& X = x.array(mfi);
+				amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						(void)k; (void)ak;
+						if (AMREX_D_TERM(((i%3)+3)%3 == ai, && ((j%3)+3)%3 == aj, && ((k%3)+3)%3 == ak))
+							X(i,j,k,p) = 1.0;
+					});
+			}
+
+			Fapply(amrlev,mglev,Ax,x);
+
+			for (MFIter mfi(stencil, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				Box bx = mfi.growntilebox(1);
+				bx = bx & domain;
+				amrex::Array4<amrex::Real> const& S        = stencil.array(mfi);
+				amrex::Array4<const amrex::Real> const& AX = Ax.array(mfi);
+				amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+						(void)k; (void)ak;
+						// Offset from (i,j,k) to the probed node in its neighborhood
+						int di = (((ai - i)%3)+3)%3; if (di == 2) di = -1;
+						int dj = (((aj - j)%3)+3)%3; if (dj == 2) dj = -1;
+						int dk = 0;
+#if AMREX_SPACEDIM == 3
+						dk = (((ak - k)%3)+3)%3; if (dk == 2) dk = -1;
+#endif
+						int o = AMREX_D_TERM((di+1), + 3*(dj+1), + 9*(dk+1)); (void)dk;
+						for (int r = 0; r < ncomp; r++)
+							S(i,j,k,(o*ncomp + r)*ncomp + p) = AX(i,j,k,r);
+					});
+			}
+		}
+	}
+}
+
+void Operator<Grid::Node>::FapplyAssembled (int amrlev, int mglev, MultiFab& a_out, const MultiFab& a_in, int color) const
+{
+	BL_PROFILE("Operator::FapplyAssembled()");
+
+	const int ncomp = getNComp();
+	const int noff = AMREX_D_TERM(3,*3,*3);
+
+	amrex::Box domain(m_geom[amrlev][mglev].Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	const Dim3 lo = amrex::lbound(domain), hi = amrex::ubound(domain);
+
+	const amrex::MultiFab &stencil = *m_stencil[amrlev][mglev];
+
+	for (MFIter mfi(a_out, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		Box bx = mfi.tilebox();
+		bx.grow(1);        // Same region as Fapply
+		bx = bx & domain;
+
+		amrex::Array4<const amrex::Real> const& S  = stencil.array(mfi);
+		amrex::Array4<const amrex::Real> const& U  = a_in.array(mfi);
+		amrex::Array4<amrex::Real> const& F        = a_out.array(mfi);
+
+		amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+				if (color >= 0 && NodeColor(i,j,k) != color) return;
+				for (int r = 0; r < ncomp; r++) F(i,j,k,r) = 0.0;
+				for (int o = 0; o < noff; o++)
+				{
+					const int di = o%3 - 1, dj = (o/3)%3 - 1;
+					const int dk = (AMREX_SPACEDIM == 3) ? (o/9)%3 - 1 : 0;
+					// Neighbors outside the domain are never coupled (one-sided stencils)
+					if (i+di < lo.x || i+di > hi.x || j+dj < lo.y || j+dj > hi.y || k+dk < lo.z || k+dk > hi.z) continue;
+					for (int r = 0; r < ncomp; r++)
+						for (int p = 0; p < ncomp; p++)
+							F(i,j,k,r) += S(i,j,k,(o*ncomp + r)*ncomp + p) * U(i+di,j+dj,k+dk,p);
+				}
+			});
+	}
+}
+
+void Operator<Grid::Node>::FactorizeBottom ()
+{
+	if (!m_direct_bottom)
+	{
+		m_bottom_factorized = false;
+		m_bottom_lu.reset();
+		return;
+	}
+	if (m_bottom_version == m_coeffs_version[0]) return;
+	BL_PROFILE("Operator::FactorizeBottom()");
+
+	m_bottom_factorized = false;
+	m_bottom_lu.reset();
+	m_bottom_version = m_coeffs_version[0];
+
+	const int mglev = m_num_mg_levels[0]-1;
+	const int ncomp = getNComp();
+	const int noff = AMREX_D_TERM(3,*3,*3);
+	const amrex::Geometry &geom = m_geom[0][mglev];
+	amrex::Box domain(geom.Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+	const Dim3 lo = amrex::lbound(domain), hi = amrex::ubound(domain);
+	const long n = domain.numPts() * ncomp;
+
+	if (geom.isAnyPeriodic())
+	{
+		Util::Warning(INFO,"Direct bottom solve does not support periodic domains; using the iterative bottom solver instead");
+		return;
+	}
+	if (n > m_direct_max_size)
+	{
+		Util::Warning(INFO,"Coarsest level has ",n," unknowns (max ",m_direct_max_size,"); using the iterative bottom solver instead");
+		return;
+	}
+
+	amrex::MultiFab stencil(m_diag[0][mglev]->boxArray(), m_diag[0][mglev]->DistributionMap(), noff*ncomp*ncomp, 1);
+	AssembleStencil(0,mglev,stencil);
+
+	// Gather the whole level onto one box owned by the I/O rank
+	const int root = amrex::ParallelDescriptor::IOProcessorNumber();
+	m_bottom_ba = amrex::BoxArray(domain);
+	m_bottom_dm = amrex::DistributionMapping(amrex::Vector<int>(1,root));
+	amrex::MultiFab S(m_bottom_ba, m_bottom_dm, noff*ncomp*ncomp, 0);
+	S.ParallelCopy(stencil,0,0,noff*ncomp*ncomp);
+
+	int ok = 1;
+	for (MFIter mfi(S); mfi.isValid(); ++mfi)
+	{
+		amrex::Array4<const amrex::Real> const& A = S.array(mfi);
+		const int nx = hi.x-lo.x+1, ny = hi.y-lo.y+1;
+		auto row = [=] (int i, int j, int k, int r) -> long {
+			return (((long)(k-lo.z)*ny + (j-lo.y))*nx + (i-lo.x))*ncomp + r;
+		};
+
+		Eigen::Matrix<amrex::Real,Eigen::Dynamic,Eigen::Dynamic> M = Eigen::Matrix<amrex::Real,Eigen::Dynamic,Eigen::Dynamic>::Zero(n,n);
+		for (int k = lo.z; k <= hi.z; k++)
+		for (int j = lo.y; j <= hi.y; j++)
+		for (int i = lo.x; i <= hi.x; i++)
+			for (int o = 0; o < noff; o++)
+			{
+				const int di = o%3 - 1, dj = (o/3)%3 - 1;
+				const int dk = (AMREX_SPACEDIM == 3) ? (o/9)%3 - 1 : 0;
+				if (i+di < lo.x || i+di > hi.x || j+dj < lo.y || j+dj > hi.y || k+dk < lo.z || k+dk > hi.z) continue;
+				for (int r = 0; r < ncomp; r++)
+					for (int p = 0; p < ncomp; p++)
+						M(row(i,j,k,r),row(i+di,j+dj,k+dk,p)) += A(i,j,k,(o*ncomp + r)*ncomp + p);
+			}
+
+		// Row pivoting is enough here; a vanishing condition estimate means a singular level
+		m_bottom_lu.reset(new Eigen::PartialPivLU<Eigen::Matrix<amrex::Real,Eigen::Dynamic,Eigen::Dynamic> >(M));
+		if (!(m_bottom_lu->rcond() > std::numeric_limits<amrex::Real>::epsilon())) { ok = 0; m_bottom_lu.reset(); }
+	}
+	amrex::ParallelDescriptor::Bcast(&ok,1,root);
+
+	if (!ok) Util::Warning(INFO,"Coarsest level is singular; using the iterative bottom solver instead");
+	m_bottom_factorized = ok;
+}
+
+bool Operator<Grid::Node>::DirectBottomAvailable ()
+{
+	if (!m_direct_bottom) return false;
+	buildMasks();
+	averageDownCoeffs();
+	FactorizeBottom();
+	return m_bottom_factorized;
+}
+
+void Operator<Grid::Node>::DirectBottomSolve (amrex::MultiFab& x, const amrex::MultiFab& b) const
+{
+	BL_PROFILE("Operator::DirectBottomSolve()");
+
+	const int ncomp = getNComp();
+	amrex::MultiFab B(m_bottom_ba, m_bottom_dm, ncomp, 0);
+	amrex::MultiFab X(m_bottom_ba, m_bottom_dm, ncomp, 0);
+	B.ParallelCopy(b,0,0,ncomp);
+
+	for (MFIter mfi(B); mfi.isValid(); ++mfi)
+	{
+		const Box &bx = mfi.validbox();
+		const Dim3 lo = amrex::lbound(bx), hi = amrex::ubound(bx);
+		amrex::Array4<const amrex::Real> const& BB = B.array(mfi);
+		amrex::Array4<amrex::Real> const& XX       = X.array(mfi);
+
+		// Same ordering as the factorized matrix: component fastest, then i, j, k
+		Eigen::Matrix<amrex::Real,Eigen::Dynamic,1> rhs(bx.numPts()*ncomp);
+		long n = 0;
+		for (int k = lo.z; k <= hi.z; k++)
+		for (int j = lo.y; j <= hi.y; j++)
+		for (int i = lo.x; i <= hi.x; i++)
+			for (int r = 0; r < ncomp; r++) rhs(n++) = BB(i,j,k,r);
+
+		Eigen::Matrix<amrex::Real,Eigen::Dynamic,1> sol = m_bottom_lu->solve(rhs);
+
+		n = 0;
+		for (int k = lo.z; k <= hi.z; k++)
+		for (int j = lo.y; j <= hi.y; j++)
+		for (int i = lo.x; i <= hi.x; i++)
+			for (int r = 0; r < ncomp; r++) XX(i,j,k,r) = sol(n++);
+	}
+
+	x.ParallelCopy(X,0,0,ncomp);
+}
+
+void Operator<Grid::Node>::Eigenvalues (bool recompute)
+{
+	BL_PROFILE("Operator::Eigenvalues()");
+	for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	{
+		for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+		{
+			if (!recompute && m_lambda_version[amrlev][mglev] == m_coeffs_version[amrlev]) continue;
+			Eigenvalue(amrlev,mglev);
+		}
+	}
+}
+
+void Operator<Grid::Node>::Eigenvalue (int amrlev, int mglev)
+{
+	UpdateDiagonal(amrlev,mglev);
+	m_lambda_max[amrlev][mglev] = MaxEigenvalue(amrlev,mglev);
+	m_lambda_version[amrlev][mglev] = m_coeffs_version[amrlev];
+}
+
+amrex::Real Operator<Grid::Node>::MaxEigenvalue (int amrlev, int mglev)
+{
+	BL_PROFILE("Operator::MaxEigenvalue()");
+
+	if (m_diag_version[amrlev][mglev] != m_coeffs_version[amrlev])
+		Util::Abort(INFO,"Diagonal must be up to date before estimating eigenvalues");
+
+	const int ncomp = getNComp();
+	const int nghost = getNGrow();
+	const amrex::Geometry &geom = m_geom[amrlev][mglev];
+	amrex::Box domain(geom.Domain());
+	domain.convert(amrex::IntVect::TheNodeVector());
+
+	const amrex::MultiFab &diag = *m_diag[amrlev][mglev];
+	amrex::MultiFab v(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+	amrex::MultiFab Av(diag.boxArray(), diag.DistributionMap(), ncomp, nghost);
+	v.setVal(0.0);
+	Av.setVal(0.0);
+
+	// Deterministic pseudo-random initial guess so that all modes are represented
+	for (MFIter mfi(v, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+	{
+		Box bx = mfi.tilebox() & domain;
+		amrex::Array4<amrex::Real> const& V = v.array(mfi);
+		for (int n = 0; n < ncomp; n++)
+		{
+			amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					amrex::Real h = std::sin(12.9898*i + 78.233*j + 37.719*k + 4.581*n) * 43758.5453;
+					V(i,j,k,n) = h - std::floor(h);
+				});
+		}
+	}
+
+	amrex::Real lambda = 0.0;
+	for (int iter = 0; iter < m_power_iterations; iter++)
+	{
+		amrex::Real vnorm = std::sqrt(amrex::MultiFab::Dot(v,0,v,0,ncomp,0));
+		if (vnorm == 0.0) break;
+		v.mult(1.0/vnorm,0,ncomp,0);
+		realFillBoundary(v,geom);
+
+		Fapply(amrlev,mglev,Av,v);
+		amrex::MultiFab::Divide(Av,diag,0,0,ncomp,0);
+
+		lambda = std::sqrt(amrex::MultiFab::Dot(Av,0,Av,0,ncomp,0));
+		amrex::MultiFab::Copy(v,Av,0,0,ncomp,0);
+	}
+	return lambda;
+}
+
 void Operator<Grid::Node>::normalize (int amrlev, int mglev, MultiFab& a_x) const
 {
 	BL_PROFILE("Operator::normalize()");
@@ -187,13 +804,28 @@ void Operator<Grid::Node>::normalize (int amrlev, int mglev, MultiFab& a_x) cons
 		{
 			amrex::ParallelFor (bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
 					
-					x(i,j,k) /= diag(i,j,k);
+					x(i,j,k,n) /= diag(i,j,k,n);
 
 				} );
 		}
 	}
 }
 
+amrex::MultiFab&
+Operator<Grid::Node>::Workspace (int amrlev, int mglev, Scratch slot, const amrex::MultiFab &like) const
+{
+	std::unique_ptr<amrex::MultiFab> &ws = m_workspace[amrlev][mglev][slot];
+	if (!ws ||
+	    ws->boxArray()        != like.boxArray() ||
+	    ws->DistributionMap() != like.DistributionMap() ||
+	    ws->nComp()            < like.nComp())
+	{
+		ws.reset(new amrex::MultiFab(like.boxArray(), like.DistributionMap(),
+					     std::max(like.nComp(),getNComp()), getNGrow()));
+	}
+	return *ws;
+}
+
 Operator<Grid::Node>::Operator (const Vector<Geometry>& a_geom,
 		    const Vector<BoxArray>& a_grids,
 		    const Vector<DistributionMapping>& a_dmap,
@@ -249,6 +881,32 @@ void Operator<Grid::Node>::define (const Vector<Geometry>& a_geom,
 		 						  m_dmap[amrlev][mglev], getNComp(), nghost));
 		 }
 	 }
+	 // Force the diagonal to be computed on the first call to Diagonal()
+	 m_coeffs_version.assign(m_num_amr_levels,0);
+	 m_diag_version.resize(m_num_amr_levels);
+	 m_lambda_version.resize(m_num_amr_levels);
+	 m_lambda_max.resize(m_num_amr_levels);
+	 for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	 {
+		 m_diag_version[amrlev].assign(m_num_mg_levels[amrlev],-1);
+		 m_lambda_version[amrlev].assign(m_num_mg_levels[amrlev],-1);
+		 m_lambda_max[amrlev].assign(m_num_mg_levels[amrlev],0.0);
+	 }
+	 m_diagonal_computed = false;
+
+	 // Allocate persistent scratch space used by Fsmooth, residuals, etc.
+	 m_workspace.resize(m_num_amr_levels);
+	 for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+	 {
+		 m_workspace[amrlev].resize(m_num_mg_levels[amrlev]);
+		 for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+		 {
+			 m_workspace[amrlev][mglev].resize(NumScratch);
+			 for (int slot = 0; slot < NumScratch; ++slot)
+				 m_workspace[amrlev][mglev][slot].reset(new MultiFab(amrex::convert(m_grids[amrlev][mglev], amrex::IntVect::TheNodeVector()),
+										     m_dmap[amrlev][mglev], getNComp(), nghost));
+		 }
+	 }
 
 	// We need to instantiate the m_lobc objects.
 	// WE DO NOT USE THEM - our BCs are implemented differently.
@@ -445,10 +1103,15 @@ void Operator<Grid::Node>::fixUpResidualMask (int amrlev, iMultiFab& resmsk)
 void Operator<Grid::Node>::prepareForSolve ()
 {
 	BL_PROFILE("Operator::prepareForSolve()");
+	if (m_keep_prepared) return;
 	MLNodeLinOp::prepareForSolve();
 	buildMasks();
 	averageDownCoeffs();
-	Diagonal(true);
+	AssembleStencil();
+	Diagonal();
+	FactorizeBottom();
+	if (m_smoother == Smoother::Chebyshev) Eigenvalues();
+	if (m_smoother == Smoother::BlockJacobi) BlockInverse();
 }
 
 void Operator<Grid::Node>::restriction (int amrlev, int cmglev, MultiFab& crse, MultiFab& fine) const
@@ -549,7 +1212,7 @@ void Operator<Grid::Node>::restriction (int amrlev, int cmglev, MultiFab& crse,
 	}
 
 	amrex::Geometry geom = m_geom[amrlev][cmglev];
-	realFillBoundary(crse,geom);
+	realFillBoundary(crse,geom,&Workspace(amrlev,cmglev,ScratchFill,crse));
 	nodalSync(amrlev, cmglev, crse);
 }
 
@@ -619,7 +1282,7 @@ void Operator<Grid::Node>::interpolation (int amrlev, int fmglev, MultiFab& fine
 	}
 
 	amrex::Geometry geom = m_geom[amrlev][fmglev];
-	realFillBoundary(fine,geom);
+	realFillBoundary(fine,geom,&Workspace(amrlev,fmglev,ScratchFill,fine));
 	nodalSync(amrlev, fmglev, fine);
 }
   
@@ -640,18 +1303,23 @@ void Operator<Grid::Node>::averageDownSolutionRHS (int camrlev, MultiFab& crse_s
 
 }
 
-void Operator<Grid::Node>::realFillBoundary(MultiFab &phi, const Geometry &geom) 
+void Operator<Grid::Node>::realFillBoundary(MultiFab &phi, const Geometry &geom, MultiFab *a_tmp) 
 {
+	MultiFab & mf = phi;
+	const int ncomp = mf.nComp();
+	const int ng1 = 1;
+	const int ng2 = 2;
+	MultiFab tmpmf;
+	if (!a_tmp)
+	{
+		tmpmf.define(mf.boxArray(), mf.DistributionMap(), ncomp, ng1);
+		a_tmp = &tmpmf;
+	}
 	for (int i = 0; i < 2; i++)
 	{
-		MultiFab & mf = phi;
 		mf.FillBoundary(geom.periodicity());
-		const int ncomp = mf.nComp();
-		const int ng1 = 1;
-		const int ng2 = 2;
-		MultiFab tmpmf(mf.boxArray(), mf.DistributionMap(), ncomp, ng1);
-		MultiFab::Copy(tmpmf, mf, 0, 0, ncomp, ng1); 
-		mf.ParallelCopy   (tmpmf, 0, 0, ncomp, ng1, ng2, geom.periodicity());
+		MultiFab::Copy(*a_tmp, mf, 0, 0, ncomp, ng1); 
+		mf.ParallelCopy   (*a_tmp, 0, 0, ncomp, ng1, ng2, geom.periodicity());
 	}
 }
 
@@ -664,7 +1332,7 @@ void Operator<Grid::Node>::applyBC (int amrlev, int mglev, MultiFab& phi, BCMode
 
 	if (!skip_fillboundary) {
 
-		realFillBoundary(phi,geom);
+		realFillBoundary(phi,geom,&Workspace(amrlev,mglev,ScratchFill,phi));
 	}
 }
 
@@ -847,7 +1515,7 @@ Operator<Grid::Node>::solutionResidual (int amrlev, MultiFab& resid, MultiFab& x
 	apply(amrlev, mglev, resid, x, BCMode::Inhomogeneous, StateMode::Solution);
 	MultiFab::Xpay(resid, -1.0, b, 0, 0, ncomp, 2);
 	amrex::Geometry geom = m_geom[amrlev][mglev];
-	realFillBoundary(resid,geom);
+	realFillBoundary(resid,geom,&Workspace(amrlev,mglev,ScratchFill,resid));
 }
 
 void
@@ -859,7 +1527,7 @@ Operator<Grid::Node>::correctionResidual (int amrlev, int mglev, MultiFab& resid
 	int ncomp = b.nComp();
 	MultiFab::Xpay(resid, -1.0, b, 0, 0, ncomp, resid.nGrow());
 	amrex::Geometry geom = m_geom[amrlev][mglev];
-	realFillBoundary(resid,geom);
+	realFillBoundary(resid,geom,&Workspace(amrlev,mglev,ScratchFill,resid));
 }
 
 
@@ -4,6 +4,7 @@
 #include "IC/Affine.H"
 #include "IC/Random.H"
 #include "Operator/Elastic.H"
+#include "Solver/Nonlocal/FGMRES.H"
 
 namespace Test
 {
@@ -117,6 +118,117 @@ void Elastic::Generate()
 	}
 
 }
+
+Set::Scalar Elastic::CompositeNorm (const Set::Field<Set::Scalar> &a_field) const
+{
+	amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+	amrex::ReduceData<Set::Scalar> reduce_data(reduce_op);
+	using ReduceTuple = decltype(reduce_data)::Type;
+
+	for (int lev = 0; lev < nlevels; lev++)
+	{
+		const amrex::MultiFab &mf = *a_field[lev];
+		const int ncomp = mf.nComp();
+		std::unique_ptr<amrex::iMultiFab> owner = mf.OwnerMask(geom[lev].periodicity());
+
+		// flag = 0 on nodes that belong to another level of the composite grid
+		amrex::iMultiFab flag(mf.boxArray(), mf.DistributionMap(), 1, 0);
+		flag.setVal(1);
+		if (lev+1 < nlevels)
+		{
+			amrex::BoxArray covered = amrex::coarsen(cgrids[lev+1], ref_ratio);
+			Solver::Nonlocal::FGMRES::SetFlag(flag, covered, 0);
+			Solver::Nonlocal::FGMRES::SetFlag(flag, covered.complementIn(geom[lev].Domain()), 1);
+		}
+		if (lev > 0) Solver::Nonlocal::FGMRES::SetFlag(flag, cgrids[lev].complementIn(geom[lev].Domain()), 0);
+
+		for (amrex::MFIter mfi(mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			const amrex::Box &bx = mfi.tilebox();
+			amrex::Array4<const Set::Scalar> const &F = mf.const_array(mfi);
+			amrex::Array4<const int> const &own       = owner->const_array(mfi);
+			amrex::Array4<const int> const &f         = flag.const_array(mfi);
+			reduce_op.eval(bx, reduce_data, [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple {
+					Set::Scalar sum = 0.0;
+					if (own(i,j,k) && f(i,j,k))
+						for (int n = 0; n < ncomp; n++) sum += F(i,j,k,n)*F(i,j,k,n);
+					return {sum};
+				});
+		}
+	}
+	Set::Scalar sum = amrex::get<0>(reduce_data.value());
+	amrex::ParallelDescriptor::ReduceRealSum(sum);
+	return std::sqrt(sum);
+}
+
+int Elastic::CompareFapply(const amrex::MLNodeLinOp &a_op0, const amrex::MLNodeLinOp &a_op1,
+			   std::vector<Set::Scalar> a_tol, std::string a_label, int verbose,
+			   bool a_boundary)
+{
+	const ::Operator::Operator< ::Grid::Node> &op0 = dynamic_cast<const ::Operator::Operator< ::Grid::Node>&>(a_op0);
+	const ::Operator::Operator< ::Grid::Node> &op1 = dynamic_cast<const ::Operator::Operator< ::Grid::Node>&>(a_op1);
+
+	int failed = 0;
+	for (int amrlev = 0; amrlev < op0.m_num_amr_levels; amrlev++)
+	{
+		for (int mglev = 0; mglev < op0.m_num_mg_levels[amrlev]; mglev++)
+		{
+			amrex::BoxArray ba = amrex::convert(op0.m_grids[amrlev][mglev], amrex::IntVect::TheNodeVector());
+			const amrex::DistributionMapping &dm = op0.m_dmap[amrlev][mglev];
+			amrex::MultiFab u(ba, dm, AMREX_SPACEDIM, 2), f0(ba, dm, AMREX_SPACEDIM, 2), f1(ba, dm, AMREX_SPACEDIM, 2);
+			f0.setVal(0.0);
+			f1.setVal(0.0);
+
+			// Deterministic pseudo-random displacement, including ghost nodes
+			for (amrex::MFIter mfi(u, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+			{
+				amrex::Box bx = mfi.growntilebox();
+				amrex::Array4<Set::Scalar> const& U = u.array(mfi);
+				for (int n = 0; n < AMREX_SPACEDIM; n++)
+					amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+							Set::Scalar h = std::sin(93.9898*i + 67.345*j + 12.345*k + 1.234*n) * 24634.6345;
+							U(i,j,k,n) = h - std::floor(h);
+						});
+			}
+
+			op0.Fapply(amrlev,mglev,f0,u);
+			op1.Fapply(amrlev,mglev,f1,u);
+
+			// Nodes on the domain boundary or the edge of the patches can read models at
+			// nodes that no SetModel or restriction writes to: leave those out. Nodes at
+			// the boundaries between boxes are compared.
+			amrex::Box ndomain = amrex::convert(op0.m_geom[amrlev][mglev].Domain(), amrex::IntVect::TheNodeVector());
+			const amrex::BoxArray outside = amrex::complementIn(amrex::grow(ndomain,1), ba);
+			for (amrex::MFIter mfi(f0); mfi.isValid() && !a_boundary; ++mfi)
+			{
+				amrex::Array4<Set::Scalar> const& F0 = f0.array(mfi);
+				amrex::Array4<Set::Scalar> const& F1 = f1.array(mfi);
+				for (int b = 0; b < (int)outside.size(); b++)
+				{
+					const amrex::Box masked = amrex::grow(outside[b],1) & mfi.validbox();
+					if (!masked.ok()) continue;
+					amrex::ParallelFor (masked,AMREX_SPACEDIM,[=] AMREX_GPU_DEVICE(int i, int j, int k, int n) {
+							F0(i,j,k,n) = 0.0;
+							F1(i,j,k,n) = 0.0;
+						});
+				}
+			}
+
+			amrex::MultiFab::Subtract(f1,f0,0,0,AMREX_SPACEDIM,0);
+			Set::Scalar norm = 0.0, error = 0.0;
+			for (int n = 0; n < AMREX_SPACEDIM; n++)
+			{
+				norm  = std::max(norm, f0.norm0(n));
+				error = std::max(error,f1.norm0(n));
+			}
+
+			const Set::Scalar tol = a_tol[std::min<std::size_t>(mglev, a_tol.size()-1)];
+			if (verbose > 0) Util::Message(INFO,a_label,"amrlev=",amrlev," mglev=",mglev,": relative difference ",error/norm);
+			if (error > tol*norm) failed++;
+		}
+	}
+	return failed;
+}
 }
 }
 	     
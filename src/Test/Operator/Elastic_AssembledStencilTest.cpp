@@ -0,0 +1,69 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Linear/Isotropic.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::AssembledStencilTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Linear::Isotropic;
+	model_type soft(2.6,6.0), stiff(26.0,60.0);
+
+	// A stiff inclusion, so that the stencil varies from node to node
+	const Set::Vector center(AMREX_D_DECL(0.5,0.5,0.5));
+	const Set::Scalar radius = 0.25;
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+	{
+		const Set::Scalar *DX = geom[ilev].CellSize(), *problo = geom[ilev].ProbLo();
+		for (amrex::MFIter mfi(*modelfab[ilev], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			amrex::Box bx = mfi.growntilebox();
+			amrex::Array4<model_type> const& C = modelfab[ilev]->array(mfi);
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					Set::Vector x(AMREX_D_DECL(problo[0] + i*DX[0], problo[1] + j*DX[1], problo[2] + k*DX[2]));
+					C(i,j,k) = (x - center).norm() < radius ? stiff : soft;
+				});
+		}
+	}
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	BC::Operator::Elastic<model_type> bc;
+	bc.Init(rhs_prescribed,geom);
+
+	// elastic[0]: Fapply everywhere, elastic[1]: the assembled stencil on mg levels >= 1
+	::Operator::Elastic<model_type> elastic[2];
+	for (int assembled = 0; assembled < 2; assembled++)
+	{
+		elastic[assembled].define(geom, cgrids, dmap, info);
+		if (assembled) elastic[assembled].SetAssembledStencil(1);
+		elastic[assembled].SetModel(modelfab);
+		elastic[assembled].SetBC(&bc);
+		elastic[assembled].prepareForSolve();
+	}
+
+	for (int amrlev = 0; amrlev < elastic[1].m_num_amr_levels; amrlev++)
+		for (int mglev = 1; mglev < elastic[1].m_num_mg_levels[amrlev]; mglev++)
+			if (!elastic[1].StencilAssembled(amrlev,mglev))
+			{
+				Util::Warning(INFO,"No stencil was assembled on amrlev=",amrlev,", mglev=",mglev);
+				failed++;
+			}
+
+	// The stencil is probed from Fapply, so the two agree to rounding
+	failed += CompareFapply(elastic[0], elastic[1], {1E-14, 1E-12}, "", verbose);
+
+	return failed;
+}
+}
+}
@@ -0,0 +1,66 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Linear/Isotropic.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+#include "Solver/Nonlocal/Homogenization.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::HomogenizationTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Linear::Isotropic;
+	model_type model(2.6,6.0);
+
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev) modelfab[ilev]->setVal(model);
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	::Operator::Elastic<model_type> elastic;
+	elastic.SetUniform(m_uniform);
+	elastic.define(geom, cgrids, dmap, info);
+
+	BC::Operator::Elastic<model_type> bc;
+	elastic.SetBC(&bc);
+
+	{
+		Solver::Nonlocal::Homogenization<model_type> homogenization(elastic);
+		homogenization.Solver().setVerbose(verbose);
+		if (m_maxIter > -1) homogenization.Solver().setMaxIter(m_maxIter);
+
+		// For a homogeneous material the effective stiffness is the stiffness itself
+		Set::Matrix4<AMREX_SPACEDIM,Set::Sym::MajorMinor> C = homogenization.Stiffness(modelfab, m_tol_rel, m_tol_abs);
+		Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Isotropic> Cexact = model.DDW(Set::Matrix::Zero());
+
+		Set::Scalar error = 0.0, norm = 0.0;
+		for (int i = 0; i < AMREX_SPACEDIM; i++)
+			for (int j = 0; j < AMREX_SPACEDIM; j++)
+				for (int k = 0; k < AMREX_SPACEDIM; k++)
+					for (int l = 0; l < AMREX_SPACEDIM; l++)
+					{
+						error = std::max(error, std::fabs(C(i,j,k,l) - Cexact(i,j,k,l)));
+						norm  = std::max(norm, std::fabs(Cexact(i,j,k,l)));
+					}
+		if (verbose > 0) Util::Message(INFO,"Effective stiffness error = ",error/norm);
+		if (error/norm > 1E-4) failed++;
+	}
+
+	// The operator gets its own BC back, and is no longer homogeneous
+	if (&elastic.GetBC() != &bc || elastic.Homogeneous())
+	{
+		if (verbose > 0) Util::Message(INFO,"The BC or homogeneous flag of the operator was not restored");
+		failed++;
+	}
+
+	return failed;
+}
+}
+}
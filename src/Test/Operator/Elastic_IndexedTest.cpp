@@ -0,0 +1,74 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Affine/Cubic.H"
+#include "Model/Solid/Packed.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::IndexedTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Affine::Cubic;
+	const int nphases = 3, nslots = 4;
+	std::vector<model_type> phases(nphases);
+	for (int n = 0; n < nphases; n++)
+		phases[n].Define(1.68 + 0.2*n, 1.21, 0.75, 0.3*n, 0.2 + 0.5*n, 0.7*n);
+
+	// Deterministic pseudo-random weights that sum to one, as dense weights (combined
+	// into a model per node) and as phase slots
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	Set::Field<Set::Scalar> slotfab(nlevels,ngrids,dmap,2*nslots,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+	{
+		for (amrex::MFIter mfi(*modelfab[ilev], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			amrex::Box bx = mfi.growntilebox();
+			amrex::Array4<model_type> const& C  = modelfab[ilev]->array(mfi);
+			amrex::Array4<Set::Scalar> const& S = slotfab[ilev]->array(mfi);
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					std::vector<Set::Scalar> eta(nphases);
+					Set::Scalar sum = 0.0;
+					for (int n = 0; n < nphases; n++)
+					{
+						Set::Scalar h = std::sin(12.9898*i + 78.233*j + 37.719*k + 4.581*n) * 43758.5453;
+						eta[n] = 0.1 + h - std::floor(h);
+						sum += eta[n];
+					}
+					for (int n = 0; n < nphases; n++) eta[n] /= sum;
+					C(i,j,k) = model_type::Combine(phases,eta);
+					Model::Solid::Select(eta.data(), nullptr, nphases, S, nslots, i, j, k);
+				});
+		}
+	}
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	BC::Operator::Elastic<model_type> bc;
+	bc.Init(rhs_prescribed,geom);
+
+	// elastic[0]: a combined model per node, elastic[1]: indexed storage
+	::Operator::Elastic<model_type> elastic[2];
+	for (int indexed = 0; indexed < 2; indexed++)
+	{
+		elastic[indexed].SetIndexed(indexed, nslots);
+		elastic[indexed].define(geom, cgrids, dmap, info);
+		if (indexed) elastic[indexed].SetModel(phases,slotfab);
+		else elastic[indexed].SetModel(modelfab);
+		elastic[indexed].SetBC(&bc);
+		elastic[indexed].averageDownCoeffs();
+	}
+
+	failed += CompareFapply(elastic[0], elastic[1], {1E-10}, "", verbose);
+
+	return failed;
+}
+}
+}
@@ -0,0 +1,114 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Linear/Isotropic.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+#include "Solver/Nonlocal/Linear.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::MixedPrecisionTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Linear::Isotropic;
+	model_type soft(2.6,6.0), stiff(26.0,60.0);
+
+	// A stiff inclusion, so that the restricted moduli vary from node to node
+	const Set::Vector center(AMREX_D_DECL(0.5,0.5,0.5));
+	const Set::Scalar radius = 0.25;
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+	{
+		const Set::Scalar *DX = geom[ilev].CellSize(), *problo = geom[ilev].ProbLo();
+		for (amrex::MFIter mfi(*modelfab[ilev], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			amrex::Box bx = mfi.growntilebox();
+			amrex::Array4<model_type> const& C = modelfab[ilev]->array(mfi);
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					Set::Vector x(AMREX_D_DECL(problo[0] + i*DX[0], problo[1] + j*DX[1], problo[2] + k*DX[2]));
+					C(i,j,k) = (x - center).norm() < radius ? stiff : soft;
+				});
+		}
+	}
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	// Stretch by 10% in x, all other boundary displacements fixed
+	const Set::Scalar stretch = 0.1;
+	BC::Operator::Elastic<model_type> bc;
+	bc.Set(bc.Face::XHI, bc.Direction::X, bc.Type::Displacement, stretch);
+	AMREX_D_TERM(,
+		     bc.Set(bc.Face::XHI_YLO,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     ,
+		     bc.Set(bc.Face::ZLO_XHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::ZHI_XHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YLO_ZLO,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YLO_ZHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YHI_ZLO,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YHI_ZHI,bc.Direction::X,bc.Type::Displacement,stretch););
+	bc.Init(rhs_prescribed,geom);
+
+	Set::Field<Set::Scalar> reference(nlevels,ngrids,dmap,AMREX_SPACEDIM,2);
+	int iters[2] = {0,0};
+
+	// The fine models are restricted differently with object and packed storage
+	for (int packed = 0; packed < 2; packed++)
+	{
+		// elastic[0]: all levels in double, elastic[1]: mg levels >= 1 in single precision
+		::Operator::Elastic<model_type> elastic[2];
+		for (int mixed = 0; mixed < 2; mixed++)
+		{
+			elastic[mixed].SetPacked(packed);
+			elastic[mixed].define(geom, cgrids, dmap, info);
+			if (mixed) elastic[mixed].SetMixedPrecision(1);
+			elastic[mixed].SetModel(modelfab);
+			elastic[mixed].SetBC(&bc);
+			elastic[mixed].averageDownCoeffs();
+		}
+
+		// The operators agree exactly on the finest mg level, and to the rounding of
+		// the moduli below it
+		failed += CompareFapply(elastic[0], elastic[1], {1E-14, 1E-6}, "packed=" + std::to_string(packed) + " ", verbose);
+
+		// Both converge to the same solution, in about as many V-cycles
+		for (int mixed = 0; mixed < 2; mixed++)
+		{
+			for (int ilev = 0; ilev < nlevels; ++ilev) solution_numeric[ilev]->setVal(0.0);
+			Solver::Nonlocal::Linear mlmg(elastic[mixed]);
+			mlmg.setVerbose(verbose);
+			if (m_maxIter > -1) mlmg.setMaxIter(m_maxIter);
+			mlmg.solve(solution_numeric, rhs_prescribed, m_tol_rel, m_tol_abs);
+			iters[mixed] = mlmg.getNumIters();
+			if (mixed) break;
+			for (int ilev = 0; ilev < nlevels; ++ilev)
+				amrex::MultiFab::Copy(*reference[ilev], *solution_numeric[ilev], 0, 0, AMREX_SPACEDIM, 0);
+		}
+
+		Set::Scalar norm = 0.0, error = 0.0;
+		for (int ilev = 0; ilev < nlevels; ++ilev)
+		{
+			amrex::MultiFab::Copy(*solution_error[ilev], *solution_numeric[ilev], 0, 0, AMREX_SPACEDIM, 0);
+			amrex::MultiFab::Subtract(*solution_error[ilev], *reference[ilev], 0, 0, AMREX_SPACEDIM, 0);
+			for (int n = 0; n < AMREX_SPACEDIM; n++)
+			{
+				norm  = std::max(norm, reference[ilev]->norm0(n));
+				error = std::max(error, solution_error[ilev]->norm0(n));
+			}
+		}
+
+		if (verbose > 0) Util::Message(INFO,"packed=",packed,": V-cycles ",iters[0]," (double), ",iters[1]," (mixed), solution difference ",error/norm);
+		if (error > 1E-6*norm) failed++;
+		if (iters[1] > iters[0] + 1) failed++;
+	}
+
+	return failed;
+}
+}
+}
@@ -0,0 +1,126 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Elastic/NeoHookean.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+#include "Solver/Nonlocal/Newton.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::NewtonTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Elastic::NeoHookean;
+	model_type model;
+	model.mu = 3.0; model.kappa = 6.5;
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	// Stretch by 10% in x, all other boundary displacements fixed
+	const Set::Scalar stretch = 0.1;
+	BC::Operator::Elastic<model_type> bc;
+	bc.Set(bc.Face::XHI, bc.Direction::X, bc.Type::Displacement, stretch);
+	AMREX_D_TERM(,
+		     bc.Set(bc.Face::XHI_YLO,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     ,
+		     bc.Set(bc.Face::ZLO_XHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::ZHI_XHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YLO_ZLO,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YLO_ZHI,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YHI_ZLO,bc.Direction::X,bc.Type::Displacement,stretch);
+		     bc.Set(bc.Face::XHI_YHI_ZHI,bc.Direction::X,bc.Type::Displacement,stretch););
+	bc.Init(rhs_prescribed,geom);
+
+	// One Newton solve from zero displacement into solution_numeric; returns the
+	// residual norm reported by the solver
+	int nriters = 0, linear_iters = 0;
+	Set::Scalar resnorm0 = 0.0;
+	auto run = [&](int a_nriters, Set::Scalar a_tol_rel_nr, Set::Scalar a_tol_energy, bool a_line_search,
+		       bool a_inexact = false) -> Set::Scalar
+		{
+			for (int ilev = 0; ilev < nlevels; ++ilev)
+			{
+				modelfab[ilev]->setVal(model);
+				solution_numeric[ilev]->setVal(0.0);
+			}
+			::Operator::Elastic<model_type> elastic;
+			elastic.define(geom, cgrids, dmap, info);
+			elastic.SetBC(&bc);
+			Solver::Nonlocal::Newton<model_type> newton(elastic);
+			newton.setVerbose(verbose);
+			newton.setNRIters(a_nriters);
+			newton.setNRTolerance(a_tol_rel_nr, 0.0, a_tol_energy);
+			newton.setLineSearch(a_line_search);
+			newton.setInexact(a_inexact);
+			Set::Scalar resnorm = newton.solve(solution_numeric, rhs_prescribed, modelfab, m_tol_rel, m_tol_abs);
+			nriters = newton.getNRIters();
+			linear_iters = newton.getLinearIters();
+			resnorm0 = newton.getInitialResidual();
+			return resnorm;
+		};
+	// Largest difference between solution_numeric and a_ref, relative to a_ref
+	auto difference = [&](const Set::Field<Set::Scalar> &a_ref) -> Set::Scalar
+		{
+			Set::Scalar norm = 0.0, error = 0.0;
+			for (int ilev = 0; ilev < nlevels; ++ilev)
+			{
+				amrex::MultiFab::Copy(*solution_error[ilev], *solution_numeric[ilev], 0, 0, AMREX_SPACEDIM, 0);
+				amrex::MultiFab::Subtract(*solution_error[ilev], *a_ref[ilev], 0, 0, AMREX_SPACEDIM, 0);
+				for (int n = 0; n < AMREX_SPACEDIM; n++)
+				{
+					norm  = std::max(norm, a_ref[ilev]->norm0(n));
+					error = std::max(error, solution_error[ilev]->norm0(n));
+				}
+			}
+			return norm > 0.0 ? error/norm : error;
+		};
+
+	const int maxiters = 20;
+	const Set::Scalar tol_nr = 1E-6;
+
+	// Residual test: stops as soon as the residual has dropped by tol_nr
+	Set::Scalar resnorm = run(maxiters, tol_nr, 0.0, false);
+	const int exact_linear_iters = linear_iters;
+	if (verbose > 0) Util::Message(INFO,"residual test: ",nriters," iterations (",linear_iters," linear), residual ",resnorm," (initial ",resnorm0,")");
+	if (nriters >= maxiters || resnorm > tol_nr*resnorm0 || resnorm0 <= 0.0) failed++;
+	Set::Field<Set::Scalar> reference(nlevels,ngrids,dmap,AMREX_SPACEDIM,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+		amrex::MultiFab::Copy(*reference[ilev], *solution_numeric[ilev], 0, 0, AMREX_SPACEDIM, 2);
+
+	// A single step: the residual returned must be the one after the step
+	resnorm = run(1, 1E-30, 0.0, false);
+	if (verbose > 0) Util::Message(INFO,"one step: residual ",resnorm," (initial ",resnorm0,")");
+	if (nriters != 1 || !(resnorm < resnorm0)) failed++;
+
+	// Line search: converges to the same solution
+	resnorm = run(maxiters, tol_nr, 0.0, true);
+	Set::Scalar error = difference(reference);
+	if (verbose > 0) Util::Message(INFO,"line search: ",nriters," iterations, residual ",resnorm,", difference ",error);
+	if (nriters >= maxiters || resnorm > tol_nr*resnorm0 || error > 1E-4) failed++;
+
+	// Energy test alone: stops once the energy no longer changes, near the same solution
+	run(maxiters, 0.0, 1E-12, false);
+	error = difference(reference);
+	if (verbose > 0) Util::Message(INFO,"energy test: ",nriters," iterations, difference ",error);
+	if (nriters >= maxiters || error > 1E-3) failed++;
+
+	// Inexact Newton: the same solution, with fewer linear iterations in total than
+	// solving every step to the full linear tolerance
+	resnorm = run(maxiters, tol_nr, 0.0, false, true);
+	error = difference(reference);
+	if (verbose > 0) Util::Message(INFO,"inexact: ",nriters," iterations (",linear_iters," linear, ",exact_linear_iters," exact), residual ",resnorm,", difference ",error);
+	if (nriters >= maxiters || resnorm > tol_nr*resnorm0 || error > 1E-4) failed++;
+	if (linear_iters >= exact_linear_iters) failed++;
+
+	return failed;
+}
+}
+}
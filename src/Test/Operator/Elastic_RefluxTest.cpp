@@ -3,6 +3,8 @@
 #include "Operator/Elastic.H"
 #include "IC/Affine.H"
 #include "Model/Solid/Linear/Isotropic.H"
+#include "IC/Trig.H"
+#include "Solver/Nonlocal/Linear.H"
 #include "Elastic.H"
 
 namespace Test
@@ -107,5 +109,93 @@ int Elastic::RefluxTest(int verbose)
 	return failed;
 
 }
+
+int Elastic::RefluxConvergenceTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Linear::Isotropic;
+	model_type soft(2.6,6.0), stiff(260.0,600.0);
+
+	// The inclusion lies inside the refined region and is only present in the fine
+	// level models, as it would be if it were resolved by refinement alone. It is
+	// stiff enough that the coarse correction is poor unless the coarse level sees it.
+	const Set::Vector center(AMREX_D_DECL(0.5,0.5,0.5));
+	const Set::Scalar radius = 0.2;
+
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+	{
+		const Set::Scalar *DX = geom[ilev].CellSize(), *problo = geom[ilev].ProbLo();
+		for (amrex::MFIter mfi(*modelfab[ilev], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			amrex::Box bx = mfi.growntilebox();
+			amrex::Array4<model_type> const& C = modelfab[ilev]->array(mfi);
+			const bool inclusion = (ilev > 0);
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					Set::Vector x(AMREX_D_DECL(problo[0] + i*DX[0], problo[1] + j*DX[1], problo[2] + k*DX[2]));
+					C(i,j,k) = (inclusion && (x - center).norm() < radius) ? stiff : soft;
+				});
+		}
+	}
+
+	std::complex<int> i(0,1);
+	IC::Trig icrhs(geom,1.0,AMREX_D_DECL(i,i,i),dim);
+	icrhs.SetComp(0);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+	{
+		rhs_prescribed[ilev]->setVal(0.0);
+		icrhs.Initialize(ilev,rhs_prescribed);
+	}
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	// iters[0]: coarse level keeps its own models, iters[1]: fine models averaged down
+	int iters[2] = {0,0};
+	for (int average = 0; average < 2; average++)
+	{
+		::Operator::Elastic<model_type> elastic;
+		elastic.define(geom, cgrids, dmap, info);
+		elastic.SetAverageDownAMR(average);
+		elastic.SetModel(modelfab);
+		elastic.averageDownCoeffs();
+
+		// The coarse model at the center of the inclusion must be the averaged stiff one
+		// if (and only if) the fine models are averaged down
+		const amrex::IntVect mid(AMREX_D_DECL(ncells[0]/2,ncells[1]/2,ncells[2]/2));
+		int averaged = 0;
+		for (amrex::MFIter mfi(*elastic.model[0][0]); mfi.isValid(); ++mfi)
+			if (mfi.validbox().contains(mid))
+				averaged = Model::Solid::Differs((*elastic.model[0][0])[mfi](mid),soft);
+		amrex::ParallelDescriptor::ReduceIntMax(averaged);
+		if (averaged != average)
+		{
+			if (verbose > 0) Util::Message(INFO,"Coarse model at the inclusion was ",averaged ? "" : "not ","averaged down with average=",average);
+			failed++;
+		}
+
+		BC::Operator::Elastic<model_type> bc;
+		bc.Init(rhs_prescribed,geom);
+		elastic.SetBC(&bc);
+
+		for (int ilev = 0; ilev < nlevels; ++ilev) solution_numeric[ilev]->setVal(0.0);
+
+		Solver::Nonlocal::Linear mlmg(elastic);
+		mlmg.setVerbose(verbose);
+		if (m_maxIter > -1) mlmg.setMaxIter(m_maxIter);
+		mlmg.solve(solution_numeric, rhs_prescribed, m_tol_rel, m_tol_abs);
+		iters[average] = mlmg.getNumIters();
+	}
+
+	if (verbose > 0) Util::Message(INFO,"V-cycles: ",iters[0]," without coefficient averaging, ",iters[1]," with");
+
+	if (iters[1] >= iters[0]) failed++;
+
+	return failed;
+}
 }
 }
@@ -0,0 +1,81 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Linear/Isotropic.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::ReuseTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Linear::Isotropic;
+	model_type soft(2.6,6.0), stiff(26.0,60.0);
+
+	// Inclusion on the fine levels only, so that averaging down changes the coarse
+	// models under the fine patches
+	const Set::Vector center(AMREX_D_DECL(0.5,0.5,0.5));
+	const Set::Scalar radius = 0.15;
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev)
+	{
+		const Set::Scalar *DX = geom[ilev].CellSize(), *problo = geom[ilev].ProbLo();
+		for (amrex::MFIter mfi(*modelfab[ilev], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+		{
+			amrex::Box bx = mfi.growntilebox();
+			amrex::Array4<model_type> const& C = modelfab[ilev]->array(mfi);
+			const bool inclusion = (ilev > 0);
+			amrex::ParallelFor (bx,[=] AMREX_GPU_DEVICE(int i, int j, int k) {
+					Set::Vector x(AMREX_D_DECL(problo[0] + i*DX[0], problo[1] + j*DX[1], problo[2] + k*DX[2]));
+					C(i,j,k) = (inclusion && (x - center).norm() < radius) ? stiff : soft;
+				});
+		}
+	}
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	BC::Operator::Elastic<model_type> bc;
+	bc.Init(rhs_prescribed,geom);
+
+	for (int packed = 0; packed < 2; packed++)
+	{
+		::Operator::Elastic<model_type> elastic;
+		elastic.SetPacked(packed);
+		elastic.define(geom, cgrids, dmap, info);
+		elastic.SetBC(&bc);
+		elastic.SetModel(modelfab);
+		elastic.averageDownCoeffs();
+
+		// The same models again: nothing may be flagged as changed on any level
+		amrex::Vector<int> version = elastic.m_coeffs_version;
+		elastic.SetModel(modelfab);
+		for (int ilev = 0; ilev < nlevels; ++ilev)
+		{
+			if (elastic.m_coeffs_version[ilev] == version[ilev]) continue;
+			if (verbose > 0) Util::Message(INFO,"packed=",packed,": models on level ",ilev," were not reused");
+			failed++;
+		}
+
+		// A change on the coarsest level outside the fine patches must still be seen
+		for (amrex::MFIter mfi(*modelfab[0]); mfi.isValid(); ++mfi)
+			if (mfi.index() == 0) (*modelfab[0])[mfi](mfi.validbox().smallEnd()) = stiff;
+		elastic.SetModel(modelfab);
+		if (elastic.m_coeffs_version[0] == version[0])
+		{
+			if (verbose > 0) Util::Message(INFO,"packed=",packed,": a changed model was missed");
+			failed++;
+		}
+		for (amrex::MFIter mfi(*modelfab[0]); mfi.isValid(); ++mfi)
+			if (mfi.index() == 0) (*modelfab[0])[mfi](mfi.validbox().smallEnd()) = soft;
+	}
+
+	return failed;
+}
+}
+}
@@ -54,8 +54,16 @@ int Elastic::UniaxialTest(int verbose, int component, std::string plotfile)
 	nlevels = geom.size();
 
 	::Operator::Elastic<model_type> elastic;
-	elastic.SetUniform(false);
+	elastic.SetUniform(m_uniform);
 	elastic.define(geom, cgrids, dmap, info);
+	elastic.SetAssembledStencil(m_assembledMglev);
+	using Smoother = ::Operator::Operator< ::Grid::Node>::Smoother;
+	if      (m_smoother == "jacobi")       elastic.SetSmoother(Smoother::Jacobi);
+	else if (m_smoother == "gauss_seidel") elastic.SetSmoother(Smoother::GaussSeidel);
+	else if (m_smoother == "chebyshev")    elastic.SetSmoother(Smoother::Chebyshev);
+	else if (m_smoother == "block_jacobi") elastic.SetSmoother(Smoother::BlockJacobi);
+	else Util::Abort(INFO,"Invalid smoother '",m_smoother,"'; options are jacobi, gauss_seidel, chebyshev, block_jacobi");
+	if (m_mixedPrecisionMglev > 0) elastic.SetMixedPrecision(m_mixedPrecisionMglev);
 	for (int ilev = 0; ilev < nlevels; ++ilev)
 		elastic.SetModel(ilev, *modelfab[ilev]);
 	BC::Operator::Elastic<model_type> bc;
@@ -136,6 +144,8 @@ int Elastic::UniaxialTest(int verbose, int component, std::string plotfile)
 	mlmg.setVerbose(verbose);
 	if (m_bottomMaxIter > -1)
 		mlmg.setBottomMaxIter(m_bottomMaxIter);
+	mlmg.setDirectBottom(m_directBottom);
+	mlmg.setFGMRES(m_fgmres);
 
 	if (component != 0)
 	{
@@ -146,6 +156,13 @@ int Elastic::UniaxialTest(int verbose, int component, std::string plotfile)
 			   rhs_prescribed,
 			   modelfab,
 			   m_tol_rel, m_tol_abs,nullptr);
+	m_numIters = mlmg.getLinearIters();
+
+	// Residual left by the solve
+	mlmg.apply(GetVecOfPtrs(res_numeric), GetVecOfPtrs(solution_numeric));
+	for (int i = 0; i < nlevels; i++)
+		amrex::MultiFab::Xpay(*res_numeric[i], -1.0, *rhs_prescribed[i], 0, 0, AMREX_SPACEDIM, 0);
+	m_residual = CompositeNorm(res_numeric);
 
 	// Compute solution error
 	for (int i = 0; i < nlevels; i++)
@@ -0,0 +1,46 @@
+#include "Test/Operator/Elastic.H"
+#include "Model/Solid/Linear/Isotropic.H"
+#include "Operator/Elastic.H"
+#include "BC/Operator/Elastic.H"
+
+namespace Test
+{
+namespace Operator
+{
+int Elastic::UniformTest(int verbose)
+{
+	Generate();
+	int failed = 0;
+
+	using model_type = Model::Solid::Linear::Isotropic;
+	model_type model(2.6,6.0);
+
+	Set::Field<model_type> modelfab(nlevels,ngrids,dmap,1,2);
+	for (int ilev = 0; ilev < nlevels; ++ilev) modelfab[ilev]->setVal(model);
+
+	amrex::LPInfo info;
+ 	info.setAgglomeration(m_agglomeration);
+ 	info.setConsolidation(m_consolidation);
+ 	if (m_maxCoarseningLevel > -1) info.setMaxCoarseningLevel(m_maxCoarseningLevel);
+
+	BC::Operator::Elastic<model_type> bc;
+	bc.Init(rhs_prescribed,geom);
+
+	// elastic[0]: a model per node, elastic[1]: uniform moduli
+	::Operator::Elastic<model_type> elastic[2];
+	for (int uniform = 0; uniform < 2; uniform++)
+	{
+		elastic[uniform].SetUniform(uniform);
+		elastic[uniform].define(geom, cgrids, dmap, info);
+		elastic[uniform].SetModel(modelfab);
+		elastic[uniform].SetBC(&bc);
+		elastic[uniform].averageDownCoeffs();
+	}
+	if (!elastic[1].m_uniform) { Util::Warning(INFO,"Uniform moduli were not detected"); return 1; }
+
+	failed += CompareFapply(elastic[0], elastic[1], {1E-10}, "", verbose, true);
+
+	return failed;
+}
+}
+}
@@ -0,0 +1,60 @@
+#include <stdlib.h>
+
+#include "Util/Util.H"
+
+#include "Test/Set/Matrix4.H"
+#include "Test/Operator/Elastic.H"
+
+/// Timings that are not pass/fail tests: run by hand (build with -O3, and with
+/// AMREX_SPACEDIM=3 for the 3D numbers) to measure the effect of a change.
+int main (int argc, char* argv[])
+{
+	Util::Initialize(argc, argv);
+
+	// Contraction with a Matrix3, as in Operator::Elastic::Fapply, summed through
+	// the old if-chain element access, through the Set::Voigt tables, and with the
+	// unrolled kernel (million contractions/s)
+	Util::Message(INFO,"Set::Matrix4 contractions");
+	{
+		const int n = 1000000;
+		Set::Scalar chain, table, kernel;
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::MajorMinor> test_majorminor;
+		test_majorminor.ContractionBenchmark(n,chain,table,kernel);
+		Util::Message(INFO,"MajorMinor: ",chain," (if-chain), ",table," (tables), ",kernel," (kernel)");
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Major> test_major;
+		test_major.ContractionBenchmark(n,chain,table,kernel);
+		Util::Message(INFO,"Major:      ",chain," (if-chain), ",table," (tables), ",kernel," (kernel)");
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Full> test_full;
+		test_full.ContractionBenchmark(n,chain,table,kernel);
+		Util::Message(INFO,"Full:       ",chain," (if-chain), ",table," (tables), ",kernel," (kernel)");
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Isotropic> test_isotropic;
+		test_isotropic.ContractionBenchmark(n,chain,table,kernel);
+		Util::Message(INFO,"Isotropic:  ",table," (element access), ",kernel," (kernel)");
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Diagonal> test_diagonal;
+		test_diagonal.ContractionBenchmark(n,chain,table,kernel);
+		Util::Message(INFO,"Diagonal:   ",table," (element access), ",kernel," (kernel)");
+	}
+
+	// Time to solution of the uniaxial test with all moduli in double, and with the
+	// moduli of the coarse multigrid levels in single precision
+	Util::Message(INFO,"Elastic Operator Uniaxial Test 64^n, mixed precision");
+	{
+		Set::Scalar time[2];
+		int iters[2];
+		for (int mixed = 0; mixed < 2; mixed++)
+		{
+			Test::Operator::Elastic test;
+			test.Define(64,1);
+			test.setMixedPrecision(mixed ? 1 : -1);
+			Set::Scalar start = amrex::ParallelDescriptor::second();
+			if (test.UniaxialTest(0,0)) Util::Warning(INFO,"Uniaxial test failed with mixed=",mixed);
+			time[mixed] = amrex::ParallelDescriptor::second() - start;
+			iters[mixed] = test.getNumIters();
+		}
+		amrex::ParallelDescriptor::ReduceRealMax(time,2);
+		Util::Message(INFO,"Double: ",time[0],"s (",iters[0]," V-cycles), mixed precision: ",time[1],"s (",iters[1]," V-cycles)");
+	}
+
+	Util::Finalize();
+	return 0;
+}
@@ -18,6 +18,7 @@
 #include "Model/Solid/Elastic/Elastic.H"
 #include "Model/Solid/Elastic/NeoHookean.H"
 #include "Model/Solid/Linear/Isotropic.H"
+#include "Model/Solid/Linear/Cubic.H"
 
 int main (int argc, char* argv[])
 {
@@ -37,6 +38,21 @@ int main (int argc, char* argv[])
 		int subfailed = 0;
 		failed += Util::Test::SubFinalMessage(subfailed);
 	}
+	Util::Test::Message("Model::Solid::Linear::Cubic");
+	{
+		int subfailed = 0;
+		subfailed += Util::Test::SubMessage("DerivativeTest1", Model::Solid::Solid<Set::Sym::MajorMinor>::DerivativeTest1<Model::Solid::Linear::Cubic>(true));
+		subfailed += Util::Test::SubMessage("RotationTest", Model::Solid::Linear::Cubic::RotationTest(true));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Model::Solid::Elastic::NeoHookean");
+	{
+		int subfailed = 0;
+		subfailed += Util::Test::SubMessage("DerivativeTest1", Model::Solid::Solid<Set::Sym::Major>::DerivativeTest1<Model::Solid::Elastic::NeoHookean>(true));
+		subfailed += Util::Test::SubMessage("DerivativeTest2", Model::Solid::Solid<Set::Sym::Major>::DerivativeTest2<Model::Solid::Elastic::NeoHookean>(true));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
 
 	Util::Test::Message("Set::Matrix4");
 	{
@@ -49,6 +65,22 @@ int main (int argc, char* argv[])
 		subfailed += Util::Test::SubMessage("3D - MajorMinor", test_3d_majorminor.SymmetryTest(0));
 	}
 
+	Util::Test::Message("Set::Matrix4 contractions");
+	{
+		int subfailed = 0;
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::MajorMinor> test_majorminor;
+		subfailed += Util::Test::SubMessage("MajorMinor", test_majorminor.ContractionTest(0));
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Major> test_major;
+		subfailed += Util::Test::SubMessage("Major",      test_major.ContractionTest(0));
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Full> test_full;
+		subfailed += Util::Test::SubMessage("Full",       test_full.ContractionTest(0));
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Isotropic> test_isotropic;
+		subfailed += Util::Test::SubMessage("Isotropic",  test_isotropic.ContractionTest(0));
+		Test::Set::Matrix4<AMREX_SPACEDIM,Set::Sym::Diagonal> test_diagonal;
+		subfailed += Util::Test::SubMessage("Diagonal",   test_diagonal.ContractionTest(0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
 	Util::Test::Message("Model::Solid::Linear::Laplacian");
 	{
 		int subfailed = 0;
@@ -128,6 +160,8 @@ int main (int argc, char* argv[])
 		subfailed += Util::Test::SubMessage("1 level,  Component 0, period=1",test.TrigTest(0,0,1));
 		test.Define(32,2);
 		subfailed += Util::Test::SubMessage("2 levels, Reflux test",          test.RefluxTest(0));
+		subfailed += Util::Test::SubMessage("2 levels, Reflux convergence",   test.RefluxConvergenceTest(0));
+		subfailed += Util::Test::SubMessage("2 levels, Coefficient reuse",    test.ReuseTest(0));
 		subfailed += Util::Test::SubMessage("2 levels, Component 0, period=1",test.TrigTest(0,0,1));
 		test.Define(32,3);
 		subfailed += Util::Test::SubMessage("3 levels, Reflux test",          test.RefluxTest(0));
@@ -135,6 +169,45 @@ int main (int argc, char* argv[])
 		failed += Util::Test::SubFinalMessage(subfailed);
 	}
 
+	Util::Test::Message("Elastic Operator Uniform Moduli Test 32^n");
+	{
+		int subfailed = 0;
+		Test::Operator::Elastic test;
+		test.Define(32,1);
+		subfailed += Util::Test::SubMessage("1 level,  ApplyUniform matches Fapply",test.UniformTest(0));
+		test.Define(32,2);
+		subfailed += Util::Test::SubMessage("2 levels, ApplyUniform matches Fapply",test.UniformTest(0));
+		test.setUniform(true);
+		subfailed += Util::Test::SubMessage("2 levels, Trig test, uniform",       test.TrigTest(0,0,1));
+		subfailed += Util::Test::SubMessage("2 levels, Uniaxial test, uniform",   test.UniaxialTest(0,0));
+		subfailed += Util::Test::SubMessage("2 levels, Homogenization, uniform",  test.HomogenizationTest(0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Elastic Operator Indexed Storage Test 32^n");
+	{
+		int subfailed = 0;
+		Test::Operator::Elastic test;
+		test.Define(32,1);
+		subfailed += Util::Test::SubMessage("1 level,  mixed phases match Combine",test.IndexedTest(0));
+		test.Define(32,2);
+		subfailed += Util::Test::SubMessage("2 levels, mixed phases match Combine",test.IndexedTest(0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Elastic Operator Assembled Stencil Test 32^n");
+	{
+		int subfailed = 0;
+		Test::Operator::Elastic test;
+		test.Define(32,1);
+		subfailed += Util::Test::SubMessage("1 level,  stencil matches Fapply", test.AssembledStencilTest(0));
+		test.Define(32,2);
+		subfailed += Util::Test::SubMessage("2 levels, stencil matches Fapply", test.AssembledStencilTest(0));
+		test.setAssembledStencil(1);
+		subfailed += Util::Test::SubMessage("2 levels, Uniaxial test, assembled", test.UniaxialTest(0,0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
 	Util::Test::Message("Elastic Operator Uniaxial Test 32^n");
 	{
 		int subfailed = 0;
@@ -149,6 +222,104 @@ int main (int argc, char* argv[])
 		subfailed += Util::Test::SubMessage("2 non-centered levels, Component 0",test.UniaxialTest(0,0));
 		failed += Util::Test::SubFinalMessage(subfailed);
 	}
+
+	// The exact coarsest level solve should never take more V-cycles than BiCGStab
+	Util::Test::Message("Elastic Operator Uniaxial Test 32^n, direct bottom solver");
+	{
+		int subfailed = 0;
+		for (int nlevels = 1; nlevels <= 2; nlevels++)
+		{
+			int iters[2] = {0,0};
+			for (int direct = 0; direct < 2; direct++)
+			{
+				Test::Operator::Elastic test;
+				test.Define(32,nlevels);
+				test.setDirectBottom(direct);
+				subfailed += Util::Test::SubMessage(std::to_string(nlevels) + (direct ? " level(s), direct" : " level(s), bicgstab"), test.UniaxialTest(0,0));
+				iters[direct] = test.getNumIters();
+			}
+			subfailed += Util::Test::SubMessage(std::to_string(nlevels) + " level(s), direct V-cycles <= bicgstab V-cycles", iters[1] > iters[0]);
+		}
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	// Every smoother should converge in no more V-cycles than point Jacobi
+	Util::Test::Message("Elastic Operator Uniaxial Test 32^n, smoothers");
+	{
+		int subfailed = 0;
+		const std::vector<std::string> smoothers = {"jacobi", "gauss_seidel", "chebyshev", "block_jacobi"};
+		for (int nlevels = 1; nlevels <= 2; nlevels++)
+		{
+			std::vector<int> iters(smoothers.size(),0);
+			for (unsigned int s = 0; s < smoothers.size(); s++)
+			{
+				Test::Operator::Elastic test;
+				test.Define(32,nlevels);
+				test.setSmoother(smoothers[s]);
+				subfailed += Util::Test::SubMessage(std::to_string(nlevels) + " level(s), " + smoothers[s], test.UniaxialTest(0,0));
+				iters[s] = test.getNumIters();
+				if (s > 0)
+					subfailed += Util::Test::SubMessage(std::to_string(nlevels) + " level(s), " + smoothers[s] + " V-cycles <= jacobi V-cycles", iters[s] > iters[0]);
+			}
+		}
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Elastic Operator Uniaxial Test 32^n, FGMRES");
+	{
+		int subfailed = 0;
+		for (int nlevels = 1; nlevels <= 2; nlevels++)
+		{
+			int iters[2] = {0,0};
+			Set::Scalar residual[2] = {0.0,0.0};
+			for (int fgmres = 0; fgmres < 2; fgmres++)
+			{
+				Test::Operator::Elastic test;
+				test.Define(32,nlevels);
+				test.setFGMRES(fgmres);
+				subfailed += Util::Test::SubMessage(std::to_string(nlevels) + (fgmres ? " level(s), FGMRES" : " level(s), MLMG"), test.UniaxialTest(0,0));
+				iters[fgmres] = test.getNumIters();
+				residual[fgmres] = test.getResidual();
+			}
+			subfailed += Util::Test::SubMessage(std::to_string(nlevels) + " level(s), FGMRES iterations <= MLMG V-cycles", iters[1] > iters[0]);
+			// Both stop at the same relative tolerance, in different norms
+			subfailed += Util::Test::SubMessage(std::to_string(nlevels) + " level(s), FGMRES residual within 10x of MLMG", residual[1] > 10.0*residual[0]);
+		}
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Elastic Operator Mixed Precision Test 32^n");
+	{
+		int subfailed = 0;
+		Test::Operator::Elastic test;
+		test.Define(32,1);
+		subfailed += Util::Test::SubMessage("1 level,  float coarse moduli match double", test.MixedPrecisionTest(0));
+		test.Define(32,2);
+		subfailed += Util::Test::SubMessage("2 levels, float coarse moduli match double", test.MixedPrecisionTest(0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Elastic Operator Newton Test 32^n");
+	{
+		int subfailed = 0;
+		Test::Operator::Elastic test;
+		test.Define(32,1);
+		subfailed += Util::Test::SubMessage("1 level,  NeoHookean stretch", test.NewtonTest(0));
+		test.Define(32,2);
+		subfailed += Util::Test::SubMessage("2 levels, NeoHookean stretch", test.NewtonTest(0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
+
+	Util::Test::Message("Elastic Operator Homogenization Test 32^n");
+	{
+		int subfailed = 0;
+		Test::Operator::Elastic test;
+		test.Define(32,1);
+		subfailed += Util::Test::SubMessage("1 level",  test.HomogenizationTest(0));
+		test.Define(32,2);
+		subfailed += Util::Test::SubMessage("2 levels", test.HomogenizationTest(0));
+		failed += Util::Test::SubFinalMessage(subfailed);
+	}
 	
 
 	Util::Message(INFO,failed," tests failed");